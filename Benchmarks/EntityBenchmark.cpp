@@ -0,0 +1,224 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "JuEngine/Entity/EntityView.hpp"
+#include "JuEngine/Entity/Pool.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace JuEngine;
+
+// Cost of Pool::HasEntity with pools from 1k to 1M entities. The lookups in entity order show the
+// cost of the lookup itself (it should stay flat), the random ones (like the updates received from
+// the network) also pay the cache misses of a big pool.
+static const unsigned int LookupCount = 1000000;
+
+// Cost per entity of creating entities with two components in a pool with a group of them, one by
+// one (each Add matches the group again) and with Pool::CreateEntities from a prototype
+static const unsigned int CreationRepeatCount = 5;
+
+// Cost per entity of each storage mode, iterating two components with a view and adding and removing
+// a third one (the structural change that moves the components in the Archetype and SparseSet modes)
+static const unsigned int StorageEntityCount = 100000;
+
+struct BenchmarkPosition : public IComponent
+{
+	void Reset(float x = 0.f, float y = 0.f)
+	{
+		mX = x;
+		mY = y;
+	}
+
+	float mX, mY;
+};
+
+struct BenchmarkVelocity : public IComponent
+{
+	void Reset(float x = 0.f, float y = 0.f)
+	{
+		mX = x;
+		mY = y;
+	}
+
+	float mX, mY;
+};
+
+struct BenchmarkTag : public IComponent
+{
+	void Reset()
+	{
+	}
+};
+
+template <typename TFunction>
+static auto Measure(TFunction function) -> double
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	function();
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+template <typename TFunction>
+static auto MeasureCreation(const unsigned int entityCount, TFunction function) -> double
+{
+	double best = 0.0;
+
+	for(unsigned int i = 0; i < CreationRepeatCount; ++i)
+	{
+		Pool pool;
+		pool.GetGroup(Matcher_AllOf(BenchmarkPosition, BenchmarkVelocity));
+
+		auto start = std::chrono::high_resolution_clock::now();
+
+		function(pool);
+
+		auto end = std::chrono::high_resolution_clock::now();
+		auto cost = std::chrono::duration<double, std::nano>(end - start).count() / entityCount;
+
+		best = (i == 0 || cost < best ? cost : best);
+	}
+
+	return best;
+}
+
+template <typename T>
+static auto MeasureLookups(const Pool& pool, const std::vector<T>& lookups, unsigned int& found) -> double
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	for(const auto &lookup : lookups)
+	{
+		found += pool.HasEntity(lookup) ? 1 : 0;
+	}
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count() / lookups.size();
+}
+
+int main()
+{
+	std::mt19937 random(1234);
+	unsigned int found = 0;
+
+	printf("%10s %14s %14s %14s %14s\n", "entities", "ordered (ns)", "EntityPtr (ns)", "EntityId (ns)", "stale id (ns)");
+
+	for(unsigned int entityCount = 1000; entityCount <= 1000000; entityCount *= 10)
+	{
+		Pool pool;
+		auto entities = pool.CreateEntities(entityCount);
+
+		std::vector<EntityPtr> entityLookups;
+		std::vector<EntityId> idLookups;
+		std::vector<EntityId> staleLookups;
+		std::uniform_int_distribution<unsigned int> distribution(0, entityCount - 1);
+
+		entityLookups.reserve(LookupCount);
+		idLookups.reserve(LookupCount);
+		staleLookups.reserve(LookupCount);
+
+		for(unsigned int i = 0; i < LookupCount; ++i)
+		{
+			const auto &entity = entities[distribution(random)];
+
+			entityLookups.push_back(entity);
+			idLookups.push_back(entity->GetId());
+			staleLookups.push_back(EntityId(entity->GetIndex(), entity->GetId().version + 1));
+		}
+
+		auto orderedLookups = idLookups;
+		std::sort(orderedLookups.begin(), orderedLookups.end(), [](const EntityId& left, const EntityId& right)
+		{
+			return left.index < right.index;
+		});
+
+		auto orderedCost = MeasureLookups(pool, orderedLookups, found);
+		auto entityCost = MeasureLookups(pool, entityLookups, found);
+		auto idCost = MeasureLookups(pool, idLookups, found);
+		auto staleCost = MeasureLookups(pool, staleLookups, found);
+
+		printf("%10u %14.2f %14.2f %14.2f %14.2f\n", entityCount, orderedCost, entityCost, idCost, staleCost);
+	}
+
+	Pool prototypePool;
+	auto prototype = prototypePool.CreateEntity()->Add<BenchmarkPosition>(1.f, 2.f)->Add<BenchmarkVelocity>(3.f, 4.f);
+	unsigned int created = 0;
+
+	printf("\n%10s %14s %14s\n", "entities", "one by one", "prototype");
+
+	for(unsigned int entityCount = 1000; entityCount <= 100000; entityCount *= 10)
+	{
+		auto oneByOneCost = MeasureCreation(entityCount, [&](Pool& pool)
+		{
+			for(unsigned int i = 0; i < entityCount; ++i)
+			{
+				pool.CreateEntity()->Add<BenchmarkPosition>(1.f, 2.f)->Add<BenchmarkVelocity>(3.f, 4.f);
+			}
+
+			created += pool.GetEntityCount();
+		});
+
+		auto prototypeCost = MeasureCreation(entityCount, [&](Pool& pool)
+		{
+			pool.CreateEntities(entityCount, prototype);
+
+			created += pool.GetEntityCount();
+		});
+
+		printf("%10u %11.1f ns %11.1f ns\n", entityCount, oneByOneCost, prototypeCost);
+	}
+
+	const PoolStorageMode storageModes[] = {PoolStorageMode::Pointer, PoolStorageMode::Archetype, PoolStorageMode::SparseSet};
+	const char* storageModeNames[] = {"Pointer", "Archetype", "SparseSet"};
+	float checksum = 0.f;
+
+	printf("\n%10s %14s %16s\n", "storage", "view (ns)", "add+remove (ns)");
+
+	for(unsigned int i = 0; i < 3; ++i)
+	{
+		Pool pool(1, storageModes[i]);
+		auto entities = pool.CreateEntities(StorageEntityCount, prototype);
+		auto view = pool.View<BenchmarkPosition, BenchmarkVelocity>();
+
+		auto update = [&view]()
+		{
+			view.Each([](Entity*, BenchmarkPosition& position, BenchmarkVelocity& velocity)
+			{
+				position.mX += velocity.mX;
+				position.mY += velocity.mY;
+			});
+		};
+
+		// The first pass only warms up the memory (and creates the group of the Pointer mode)
+		update();
+		auto viewCost = Measure(update) / StorageEntityCount;
+
+		auto structuralCost = Measure([&entities]()
+		{
+			for(const auto &entity : entities)
+			{
+				entity->Add<BenchmarkTag>();
+			}
+
+			for(const auto &entity : entities)
+			{
+				entity->Remove<BenchmarkTag>();
+			}
+		}) / StorageEntityCount;
+
+		checksum += entities.back()->Get<BenchmarkPosition>()->mX;
+
+		printf("%10s %14.2f %16.2f\n", storageModeNames[i], viewCost, structuralCost);
+	}
+
+	// Keeps the lookups, the creations and the updates from being optimized away
+	return (found == 3 * 4 * LookupCount && created == 2 * CreationRepeatCount * 111000 && checksum > 0.f) ? 0 : 1;
+}
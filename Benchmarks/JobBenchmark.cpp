@@ -0,0 +1,122 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "JuEngine/Managers/JobManager.hpp"
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <thread>
+#include <vector>
+
+using namespace JuEngine;
+
+// Scheduling overhead of the job manager. The empty jobs show the cost of Run + Wait per job (with
+// and without a dependency), the ParallelFor columns show from which grain size splitting a cheap loop
+// pays off against running it in a single thread.
+static const unsigned int JobCount = 100000;
+static const unsigned int ElementCount = 1 << 22;
+
+template <typename TFunction>
+static auto Measure(TFunction function) -> double
+{
+	auto start = std::chrono::high_resolution_clock::now();
+
+	function();
+
+	auto end = std::chrono::high_resolution_clock::now();
+
+	return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+int main()
+{
+	std::vector<float> data(ElementCount, 1.f);
+	std::atomic<unsigned int> executed{0};
+	float checksum = 0.f;
+
+	auto loop = [&data]()
+	{
+		for(auto &value : data)
+		{
+			value = value * 0.5f + 0.5f;
+		}
+	};
+
+	// The first pass only warms up the memory
+	loop();
+	auto loopCost = Measure(loop);
+
+	checksum += data[0];
+
+	printf("single thread loop (%u elements): %.3f ms\n\n", ElementCount, loopCost / 1000000.0);
+	printf("%8s %14s %16s %14s %14s %14s\n", "workers", "job (ns)", "dependent (ns)", "grain 256", "grain 4096", "grain 65536");
+
+	const unsigned int hardwareCount = std::thread::hardware_concurrency();
+
+	for(unsigned int workerCount : {0u, 1u, 2u, hardwareCount > 1 ? hardwareCount - 1 : 3u})
+	{
+		JobManager jobs(workerCount);
+
+		auto jobCost = Measure([&]()
+		{
+			JobCounter counter;
+
+			for(unsigned int i = 0; i < JobCount; ++i)
+			{
+				jobs.Run([&executed]()
+				{
+					++executed;
+				}, &counter);
+			}
+
+			jobs.Wait(counter);
+		});
+
+		auto dependentCost = Measure([&]()
+		{
+			JobCounter dependency;
+			JobCounter counter;
+
+			jobs.Run([&executed]()
+			{
+				++executed;
+			}, &dependency);
+
+			for(unsigned int i = 0; i < JobCount; ++i)
+			{
+				jobs.Run([&executed]()
+				{
+					++executed;
+				}, &counter, &dependency);
+			}
+
+			jobs.Wait(counter);
+		});
+
+		double grainCosts[3];
+		unsigned int grainIndex = 0;
+
+		for(unsigned int grainSize : {256u, 4096u, 65536u})
+		{
+			grainCosts[grainIndex++] = Measure([&]()
+			{
+				jobs.ParallelFor(ElementCount, grainSize, [&data](const unsigned int begin, const unsigned int end)
+				{
+					for(unsigned int i = begin; i < end; ++i)
+					{
+						data[i] = data[i] * 0.5f + 0.5f;
+					}
+				});
+			});
+
+			checksum += data[0];
+		}
+
+		printf("%8u %14.1f %16.1f %11.3f ms %11.3f ms %11.3f ms\n", workerCount, jobCost / JobCount, dependentCost / JobCount,
+			grainCosts[0] / 1000000.0, grainCosts[1] / 1000000.0, grainCosts[2] / 1000000.0);
+	}
+
+	// Keeps the work from being optimized away
+	return (executed == 4 * (2 * JobCount + 1) && checksum > 0.f) ? 0 : 1;
+}
@@ -6,7 +6,9 @@
 #include "Services/IAppController.hpp"
 #include "Services/IDataService.hpp"
 #include "Services/IInputService.hpp"
+#include "Services/IJobService.hpp"
 #include "Services/ILevelService.hpp"
+#include "Services/ISpatialService.hpp"
 #include "Services/ISystemService.hpp"
 #include "Services/ITimeService.hpp"
 #include "Services/IWindowService.hpp"
@@ -70,6 +72,11 @@ auto App::Input() -> IInputService*
 	return static_cast<IInputService*>(App::Get(typeid(IInputService), defaultServiceId));
 }
 
+auto App::Jobs() -> IJobService*
+{
+	return static_cast<IJobService*>(App::Get(typeid(IJobService), defaultServiceId));
+}
+
 auto App::Level() -> ILevelService*
 {
 	return static_cast<ILevelService*>(App::Get(typeid(ILevelService), defaultServiceId));
@@ -80,6 +87,11 @@ auto App::Log() -> ILogService*
 	return static_cast<ILogService*>(App::Get(typeid(ILogService), defaultServiceId));
 }
 
+auto App::Spatial() -> ISpatialService*
+{
+	return static_cast<ISpatialService*>(App::Get(typeid(ISpatialService), defaultServiceId));
+}
+
 auto App::System() -> ISystemService*
 {
 	return static_cast<ISystemService*>(App::Get(typeid(ISystemService), defaultServiceId));
@@ -110,6 +122,11 @@ void App::Provide(IInputService* inputService)
 	App::Provide(typeid(IInputService), defaultServiceId, inputService);
 }
 
+void App::Provide(IJobService* jobService)
+{
+	App::Provide(typeid(IJobService), defaultServiceId, jobService);
+}
+
 void App::Provide(ILevelService* levelService)
 {
 	App::Provide(typeid(ILevelService), defaultServiceId, levelService);
@@ -120,6 +137,11 @@ void App::Provide(ILogService* logService)
 	App::Provide(typeid(ILogService), defaultServiceId, logService);
 }
 
+void App::Provide(ISpatialService* spatialService)
+{
+	App::Provide(typeid(ISpatialService), defaultServiceId, spatialService);
+}
+
 void App::Provide(ISystemService* systemService)
 {
 	App::Provide(typeid(ISystemService), defaultServiceId, systemService);
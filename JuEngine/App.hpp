@@ -14,8 +14,10 @@ namespace JuEngine
 class IAppController;
 class IDataService;
 class IInputService;
+class IJobService;
 class ILevelService;
 class ILogService;
+class ISpatialService;
 class ISystemService;
 class ITimeService;
 class IWindowService;
@@ -25,8 +27,10 @@ struct JUENGINEAPI App
 	static auto Controller() -> IAppController*;
 	static auto Data() -> IDataService*;
 	static auto Input() -> IInputService*;
+	static auto Jobs() -> IJobService*;
 	static auto Level() -> ILevelService*;
 	static auto Log() -> ILogService*;
+	static auto Spatial() -> ISpatialService*;
 	static auto System() -> ISystemService*;
 	static auto Time() -> ITimeService*;
 	static auto Window() -> IWindowService*;
@@ -34,8 +38,10 @@ struct JUENGINEAPI App
 	static void Provide(IAppController* appController);
 	static void Provide(IDataService* dataService);
 	static void Provide(IInputService* inputService);
+	static void Provide(IJobService* jobService);
 	static void Provide(ILevelService* levelService);
 	static void Provide(ILogService* logService);
+	static void Provide(ISpatialService* spatialService);
 	static void Provide(ISystemService* systemService);
 	static void Provide(ITimeService* timeService);
 	static void Provide(IWindowService* windowService);
@@ -5,8 +5,10 @@
 #include "AppController.hpp"
 #include "Managers/DataManager.hpp"
 #include "Managers/InputManager.hpp"
+#include "Managers/JobManager.hpp"
 #include "Managers/LevelManager.hpp"
 #include "Managers/LogManager.hpp"
+#include "Managers/SpatialManager.hpp"
 #include "Managers/SystemManager.hpp"
 #include "Managers/TimeManager.hpp"
 #include "Managers/WindowManager.hpp"
@@ -64,6 +66,7 @@ void AppController::Run()
 				fixedTimer.Reset();
 
 				App::Time()->FixedUpdate();
+				App::Spatial()->Update();
 				App::System()->FixedExecute();
 			}
 
@@ -76,6 +79,7 @@ void AppController::Run()
 
 				App::Time()->Update();
 				App::Input()->Update();
+				App::Spatial()->Update();
 				App::System()->Execute();
 				App::Window()->Render();
 			}
@@ -126,10 +130,12 @@ void AppController::BootstrapServices()
 	App::Provide(new TimeManager());
 	App::Provide(new LogManager());
 	App::Provide(new WindowManager());
+	App::Provide(new JobManager());
 	App::Provide(new SystemManager());
 	App::Provide(new InputManager());
 	App::Provide(new DataManager());
 	App::Provide(new LevelManager());
+	App::Provide(new SpatialManager());
 }
 
 void AppController::SetFixedInterval(const float interval)
@@ -4,11 +4,13 @@
 
 #include "Transform.hpp"
 #include "../Entity/Entity.hpp"
+#include "../Resources/TransformBatch.hpp"
 
 namespace JuEngine
 {
 void Transform::Reset()
 {
+	SetParent(nullptr);
 	SetLocalPosition(vec3(0.f, 0.f, 0.f));
 	SetLocalScale(vec3(1.f, 1.f, 1.f));
 	SetLocalRotation(quat(1.f, 0.f, 0.f, 0.f));
@@ -16,6 +18,7 @@ void Transform::Reset()
 
 void Transform::Reset(const vec3 position)
 {
+	SetParent(nullptr);
 	SetLocalPosition(position);
 	SetLocalScale(vec3(1.f, 1.f, 1.f));
 	SetLocalRotation(quat(1.f, 0.f, 0.f, 0.f));
@@ -23,6 +26,7 @@ void Transform::Reset(const vec3 position)
 
 void Transform::Reset(const vec3 position, const quat orientation)
 {
+	SetParent(nullptr);
 	SetLocalPosition(position);
 	SetLocalScale(vec3(1.f, 1.f, 1.f));
 	SetLocalRotation(orientation);
@@ -36,6 +40,13 @@ void Transform::SetParent(const EntityPtr& parent)
 void Transform::SetParent(Transform* parent)
 {
 	mParent = parent;
+	mWorldMatrixRefreshNeeded = true;
+	mWorldInverseMatrixRefreshNeeded = true;
+}
+
+auto Transform::GetParent() const -> Transform*
+{
+	return mParent;
 }
 
 vec3 Transform::GetPosition() const
@@ -297,36 +308,49 @@ void Transform::LookAt(const vec3 worldPosition, const vec3 worldUp)
 	}
 }
 
-auto Transform::GetMatrix() -> const mat4&
+auto Transform::GetLocalMatrix() -> const mat4&
 {
-	bool matrixRecalculated = false;
-
 	if(mMatrixRefreshNeeded)
 	{
-		mMatrixCache = CalculateMatrix();
-		mMatrixRefreshNeeded = false;
-		matrixRecalculated = true;
+		SetLocalMatrix(CalculateMatrix());
 	}
 
+	return mMatrixCache;
+}
+
+auto Transform::GetMatrix() -> const mat4&
+{
+	auto &localMatrix = GetLocalMatrix();
+
 	if(mParent)
 	{
-		auto parentMatrix = mParent->GetMatrix();
-
-		if(mParentWorldMatrixCache != parentMatrix)
-		{
-			mParentWorldMatrixCache = parentMatrix;
-			mWorldMatrixCache = mParentWorldMatrixCache * mMatrixCache;
-		}
+		auto &parentMatrix = mParent->GetMatrix();
 
-		if(matrixRecalculated)
+		if(mWorldMatrixRefreshNeeded || mParentMatrixVersion != mParent->mMatrixVersion)
 		{
-			mWorldMatrixCache = mParentWorldMatrixCache * mMatrixCache;
+			mWorldMatrixCache = parentMatrix * localMatrix;
+			mParentMatrixVersion = mParent->mMatrixVersion;
+			mWorldMatrixRefreshNeeded = false;
+			++mMatrixVersion;
 		}
 
 		return mWorldMatrixCache;
 	}
 
-	return mMatrixCache;
+	if(mWorldMatrixRefreshNeeded)
+	{
+		mWorldMatrixRefreshNeeded = false;
+		++mMatrixVersion;
+	}
+
+	return localMatrix;
+}
+
+auto Transform::GetMatrixVersion() -> unsigned int
+{
+	GetMatrix();
+
+	return mMatrixVersion;
 }
 
 vec3 Transform::TransformPoint(const vec3 position)
@@ -346,33 +370,34 @@ vec3 Transform::TransformDirection(const vec3 direction)
 
 auto Transform::GetInverseMatrix() -> const mat4&
 {
-	bool matrixRecalculated = false;
-
 	if(mInverseMatrixRefreshNeeded)
 	{
 		mInverseMatrixCache = CalculateInverseMatrix();
 		mInverseMatrixRefreshNeeded = false;
-		matrixRecalculated = true;
+		mWorldInverseMatrixRefreshNeeded = true;
 	}
 
 	if(mParent)
 	{
-		auto parentInverseMatrix = mParent->GetMatrix();
+		auto &parentInverseMatrix = mParent->GetInverseMatrix();
 
-		if(mParentWorldInverseMatrixCache != parentInverseMatrix)
+		if(mWorldInverseMatrixRefreshNeeded || mParentInverseMatrixVersion != mParent->mInverseMatrixVersion)
 		{
-			mParentWorldInverseMatrixCache = parentInverseMatrix;
-			mWorldInverseMatrixCache = mInverseMatrixCache * mParentWorldInverseMatrixCache;
-		}
-
-		if(matrixRecalculated)
-		{
-			mWorldInverseMatrixCache = mInverseMatrixCache * mParentWorldInverseMatrixCache;
+			mWorldInverseMatrixCache = mInverseMatrixCache * parentInverseMatrix;
+			mParentInverseMatrixVersion = mParent->mInverseMatrixVersion;
+			mWorldInverseMatrixRefreshNeeded = false;
+			++mInverseMatrixVersion;
 		}
 
 		return mWorldInverseMatrixCache;
 	}
 
+	if(mWorldInverseMatrixRefreshNeeded)
+	{
+		mWorldInverseMatrixRefreshNeeded = false;
+		++mInverseMatrixVersion;
+	}
+
 	return mInverseMatrixCache;
 }
 
@@ -393,31 +418,19 @@ vec3 Transform::InverseTransformDirection(const vec3 direction)
 
 mat4 Transform::CalculateMatrix()
 {
-	mat4 translationMatrix = mat4(1.f);
-	translationMatrix[3] = vec4(mPosition, 1.f);
-
-	mat4 scalingMatrix = mat4(1.f);
-	scalingMatrix[0][0] = mScale.x;
-	scalingMatrix[1][1] = mScale.y;
-	scalingMatrix[2][2] = mScale.z;
-
-	mat4 rotationMatrix = mat4(Math::QuatToMat(mOrientation));
-
-	return (translationMatrix * rotationMatrix * scalingMatrix);
+	return TransformBatch::CalculateMatrix(mPosition, mOrientation, mScale);
 }
 
 mat4 Transform::CalculateInverseMatrix()
 {
-	mat4 translationMatrix = mat4(1.f);
-	translationMatrix[3] = vec4(-mPosition, 1.f);
-
-	mat4 scalingMatrix = mat4(1.f);
-	scalingMatrix[0][0] = 1.f / mScale.x;
-	scalingMatrix[1][1] = 1.f / mScale.y;
-	scalingMatrix[2][2] = 1.f / mScale.z;
-
-	mat4 rotationMatrix = mat4(Math::QuatToMat(Math::Conjugate(mOrientation)));
+	return TransformBatch::CalculateInverseMatrix(mPosition, mOrientation, mScale);
+}
 
-	return (scalingMatrix * rotationMatrix * translationMatrix);
+void Transform::SetLocalMatrix(const mat4& matrix)
+{
+	mMatrixCache = matrix;
+	mMatrixRefreshNeeded = false;
+	mWorldMatrixRefreshNeeded = true;
+	++mLocalMatrixVersion;
 }
 }
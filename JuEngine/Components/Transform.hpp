@@ -11,17 +11,23 @@
 namespace JuEngine
 {
 class Entity;
+class TransformHierarchy;
 typedef std::shared_ptr<Entity> EntityPtr;
 
 class JUENGINEAPI Transform : public IComponent
 {
+	friend class TransformHierarchy;
+
 	public:
 		void Reset();
 		void Reset(const vec3 position);
 		void Reset(const vec3 position, const quat orientation);
 
+		// The parent is kept as a pointer, it needs a pool with the Pointer storage mode (the
+		// components of the other modes move in memory)
 		void SetParent(const EntityPtr& parent);
 		void SetParent(Transform* parent);
+		auto GetParent() const -> Transform*;
 		vec3 GetPosition() const;
 		vec3 GetScale() const;
 		vec3 GetEulerAngles();
@@ -49,7 +55,9 @@ class JUENGINEAPI Transform : public IComponent
 		void Rotate(const quat orientation, const Transform* relativeTo);
 		void RotateAround(const vec3 point, const vec3 axis, const float angle);
 		void LookAt(const vec3 worldPosition, const vec3 worldUp = vec3(0.f, 1.f, 0.f));
+		auto GetLocalMatrix() -> const mat4&;				// Local to Parent
 		auto GetMatrix() -> const mat4&;					// Local to World
+		auto GetMatrixVersion() -> unsigned int;			// Changes with the matrix returned by GetMatrix
 		vec3 TransformPoint(const vec3 position);
 		vec3 TransformVector(const vec3 vector);
 		vec3 TransformDirection(const vec3 direction);
@@ -61,9 +69,10 @@ class JUENGINEAPI Transform : public IComponent
 	private:
 		mat4 CalculateMatrix();
 		mat4 CalculateInverseMatrix();
+		void SetLocalMatrix(const mat4& matrix);
 
 		// TODO: Transform: If a parent entity is deleted, it must have a list of child entities to remove them too.
-		Transform* mParent;
+		Transform* mParent{nullptr};
 		vec3 mPosition{0.f, 0.f, 0.f};
 		vec3 mScale{1.f, 1.f, 1.f};
 		quat mOrientation{1.f, 0.f, 0.f, 0.f};
@@ -75,13 +84,20 @@ class JUENGINEAPI Transform : public IComponent
 		vec3 mUpCache{0.f, 1.f, 0.f};
 		bool mForwardRefreshNeeded{false};
 		vec3 mForwardCache{0.f, 0.f, 1.f};
+		// The versions change every time the matrix returned by GetMatrix/GetInverseMatrix changes,
+		// the children compare them with the versions of their last calculation
 		bool mMatrixRefreshNeeded{false};
+		bool mWorldMatrixRefreshNeeded{false};
+		unsigned int mLocalMatrixVersion{0};
+		unsigned int mMatrixVersion{0};
+		unsigned int mParentMatrixVersion{0};
 		mat4 mMatrixCache{mat4(1.f)};
 		mat4 mWorldMatrixCache{mat4(1.f)};
-		mat4 mParentWorldMatrixCache{mat4(1.f)};
 		bool mInverseMatrixRefreshNeeded{false};
+		bool mWorldInverseMatrixRefreshNeeded{false};
+		unsigned int mInverseMatrixVersion{0};
+		unsigned int mParentInverseMatrixVersion{0};
 		mat4 mInverseMatrixCache{mat4(1.f)};
 		mat4 mWorldInverseMatrixCache{mat4(1.f)};
-		mat4 mParentWorldInverseMatrixCache{mat4(1.f)};
 };
 }
@@ -0,0 +1,331 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "Archetype.hpp"
+#include "Entity.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace JuEngine
+{
+Archetype::Archetype(const ComponentIdList& indices, const std::vector<const ComponentTypeInfo*>& types) : mIndices(indices), mTypes(types), mComponentMask(ComponentTypeId::GetMask(indices))
+{
+	std::size_t rowSize = sizeof(Entity*);
+
+	for(unsigned int column = 0, columnCount = mTypes.size(); column < columnCount; ++column)
+	{
+		if(mTypes[column]->alignment > alignof(std::max_align_t))
+		{
+			ThrowRuntimeError("Error, component at index %u is over-aligned and cannot be stored in an archetype", mIndices[column]);
+		}
+
+		rowSize += mTypes[column]->size;
+
+		if(mIndices[column] >= mColumnForIndex.size())
+		{
+			mColumnForIndex.resize(mIndices[column] + 1, -1);
+		}
+
+		mColumnForIndex[mIndices[column]] = column;
+	}
+
+	mChunkCapacity = std::max<std::size_t>(1, ChunkSize / rowSize);
+	mColumnOffsets.resize(mTypes.size());
+
+	// Columns are laid out one after another (SoA), the entity column goes first
+	while(true)
+	{
+		std::size_t offset = sizeof(Entity*) * mChunkCapacity;
+
+		for(unsigned int column = 0, columnCount = mTypes.size(); column < columnCount; ++column)
+		{
+			auto alignment = mTypes[column]->alignment;
+			offset = ((offset + alignment - 1) / alignment) * alignment;
+			mColumnOffsets[column] = offset;
+			offset += mTypes[column]->size * mChunkCapacity;
+		}
+
+		if(offset <= ChunkSize || mChunkCapacity == 1)
+		{
+			mChunkBytes = std::max<std::size_t>(offset, sizeof(Entity*));
+			break;
+		}
+
+		--mChunkCapacity;
+	}
+}
+
+Archetype::~Archetype()
+{
+	while(mCount > 0)
+	{
+		RemoveRow(mCount - 1);
+	}
+
+	for(auto &chunk : mChunks)
+	{
+		::operator delete(chunk);
+	}
+}
+
+auto Archetype::GetIndices() const -> const ComponentIdList&
+{
+	return mIndices;
+}
+
+bool Archetype::HasComponent(const ComponentId index) const
+{
+	return GetColumn(index) >= 0;
+}
+
+bool Archetype::HasComponents(const ComponentIdList& indices) const
+{
+	for(const auto &index : indices)
+	{
+		if(! HasComponent(index))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+auto Archetype::GetComponentMask() const -> const ComponentMask&
+{
+	return mComponentMask;
+}
+
+auto Archetype::Count() const -> unsigned int
+{
+	return mCount;
+}
+
+auto Archetype::GetChunkCount() const -> unsigned int
+{
+	return (mCount + mChunkCapacity - 1) / mChunkCapacity;
+}
+
+auto Archetype::GetChunkCapacity() const -> unsigned int
+{
+	return mChunkCapacity;
+}
+
+auto Archetype::GetChunkRowCount(const unsigned int chunk) const -> unsigned int
+{
+	return std::min(mChunkCapacity, mCount - (chunk * mChunkCapacity));
+}
+
+auto Archetype::GetChunkEntities(const unsigned int chunk) const -> Entity* const*
+{
+	return reinterpret_cast<Entity* const*>(mChunks[chunk]);
+}
+
+auto Archetype::GetComponent(const ComponentId index, const unsigned int row) const -> IComponent*
+{
+	auto column = GetColumn(index);
+
+	if(column < 0 || row >= mCount)
+	{
+		ThrowRuntimeError("Error, archetype has no component at index %u for row %u", index, row);
+	}
+
+	return mTypes[column]->cast(GetMemory(column, row));
+}
+
+auto Archetype::GetEntity(const unsigned int row) const -> Entity*
+{
+	return GetChunkEntities(row / mChunkCapacity)[row % mChunkCapacity];
+}
+
+auto Archetype::AddRow(Entity* entity) -> unsigned int
+{
+	auto row = mCount;
+
+	if(row / mChunkCapacity >= mChunks.size())
+	{
+		mChunks.push_back(static_cast<char*>(::operator new(mChunkBytes)));
+	}
+
+	reinterpret_cast<Entity**>(mChunks[row / mChunkCapacity])[row % mChunkCapacity] = entity;
+	++mCount;
+
+	return row;
+}
+
+auto Archetype::MoveRow(const unsigned int row, Archetype* target) -> unsigned int
+{
+	auto entity = GetEntity(row);
+	auto targetRow = target->AddRow(entity);
+
+	for(unsigned int column = 0, columnCount = mTypes.size(); column < columnCount; ++column)
+	{
+		auto component = mTypes[column]->cast(GetMemory(column, row));
+		auto targetColumn = target->GetColumn(mIndices[column]);
+
+		if(targetColumn >= 0)
+		{
+			mTypes[column]->construct(target->GetMemory(targetColumn, targetRow), component);
+		}
+
+		mTypes[column]->destroy(component);
+	}
+
+	CompactRow(row);
+
+	return targetRow;
+}
+
+void Archetype::RemoveRow(const unsigned int row)
+{
+	for(unsigned int column = 0, columnCount = mTypes.size(); column < columnCount; ++column)
+	{
+		mTypes[column]->destroy(mTypes[column]->cast(GetMemory(column, row)));
+	}
+
+	CompactRow(row);
+}
+
+auto Archetype::GetMemory(const int column, const unsigned int row) const -> void*
+{
+	return mChunks[row / mChunkCapacity] + mColumnOffsets[column] + (mTypes[column]->size * (row % mChunkCapacity));
+}
+
+auto Archetype::GetColumn(const ComponentId index) const -> int
+{
+	if(index >= mColumnForIndex.size())
+	{
+		return -1;
+	}
+
+	return mColumnForIndex[index];
+}
+
+void Archetype::CompactRow(const unsigned int row)
+{
+	auto lastRow = mCount - 1;
+
+	// The row components are already destroyed, fill the gap with the last row
+	if(row != lastRow)
+	{
+		for(unsigned int column = 0, columnCount = mTypes.size(); column < columnCount; ++column)
+		{
+			auto component = mTypes[column]->cast(GetMemory(column, lastRow));
+			mTypes[column]->construct(GetMemory(column, row), component);
+			mTypes[column]->destroy(component);
+		}
+
+		auto entity = GetEntity(lastRow);
+		reinterpret_cast<Entity**>(mChunks[row / mChunkCapacity])[row % mChunkCapacity] = entity;
+		entity->mRow = row;
+	}
+
+	--mCount;
+
+	// Keep one spare chunk to avoid allocation ping-pong at chunk boundaries
+	while(mChunks.size() > GetChunkCount() + 1)
+	{
+		::operator delete(mChunks.back());
+		mChunks.pop_back();
+	}
+}
+
+// ----------------------------------------------------------------------------------------------
+
+ArchetypeStorage::ArchetypeStorage()
+{
+	GetArchetype(ComponentIdList());
+}
+
+ArchetypeStorage::~ArchetypeStorage()
+{
+	for(auto &archetype : mArchetypeList)
+	{
+		delete archetype;
+	}
+}
+
+auto ArchetypeStorage::GetType(const ComponentId index) const -> const ComponentTypeInfo*
+{
+	if(index >= mTypes.size() || mTypes[index] == nullptr)
+	{
+		ThrowRuntimeError("Error, component type at index %u is not registered in the archetype storage", index);
+	}
+
+	return mTypes[index];
+}
+
+auto ArchetypeStorage::GetRootArchetype() -> Archetype*
+{
+	return mArchetypeList.front();
+}
+
+auto ArchetypeStorage::GetArchetype(const ComponentIdList& indices) -> Archetype*
+{
+	auto it = mArchetypes.find(indices);
+
+	if(it != mArchetypes.end())
+	{
+		return it->second;
+	}
+
+	auto types = std::vector<const ComponentTypeInfo*>();
+	types.reserve(indices.size());
+
+	for(const auto &index : indices)
+	{
+		types.push_back(GetType(index));
+	}
+
+	auto archetype = new Archetype(indices, types);
+	mArchetypes[indices] = archetype;
+	mArchetypeList.push_back(archetype);
+
+	return archetype;
+}
+
+auto ArchetypeStorage::GetArchetypeWith(Archetype* archetype, const ComponentId index) -> Archetype*
+{
+	auto it = archetype->mAddEdges.find(index);
+
+	if(it != archetype->mAddEdges.end())
+	{
+		return it->second;
+	}
+
+	auto indices = archetype->GetIndices();
+	indices.insert(std::upper_bound(indices.begin(), indices.end(), index), index);
+
+	auto target = GetArchetype(indices);
+	archetype->mAddEdges[index] = target;
+	target->mRemoveEdges[index] = archetype;
+
+	return target;
+}
+
+auto ArchetypeStorage::GetArchetypeWithout(Archetype* archetype, const ComponentId index) -> Archetype*
+{
+	auto it = archetype->mRemoveEdges.find(index);
+
+	if(it != archetype->mRemoveEdges.end())
+	{
+		return it->second;
+	}
+
+	auto indices = archetype->GetIndices();
+	indices.erase(std::remove(indices.begin(), indices.end(), index), indices.end());
+
+	auto target = GetArchetype(indices);
+	archetype->mRemoveEdges[index] = target;
+	target->mAddEdges[index] = archetype;
+
+	return target;
+}
+
+auto ArchetypeStorage::GetArchetypes() const -> const std::vector<Archetype*>&
+{
+	return mArchetypeList;
+}
+}
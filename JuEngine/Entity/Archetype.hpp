@@ -0,0 +1,193 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "ComponentTypeId.hpp"
+#include <map>
+#include <unordered_map>
+#include <utility>
+#include <new>
+
+namespace JuEngine
+{
+class Entity;
+class IComponentArray;
+
+struct JUENGINEAPI ComponentTypeInfo
+{
+	public:
+		template <typename T> inline static auto Get() -> const ComponentTypeInfo*;
+
+		std::size_t size;
+		std::size_t alignment;
+		IComponent* (*constructDefault)(void* memory);
+		IComponent* (*construct)(void* memory, IComponent* source);
+		IComponent* (*cast)(void* memory);
+		void (*swap)(IComponent* left, IComponent* right);
+		void (*copy)(IComponent* destination, const IComponent* source);
+		void (*destroy)(IComponent* component);
+		void (*release)(IComponent* component);
+		IComponentArray* (*createArray)();
+};
+
+class JUENGINEAPI Archetype
+{
+	friend class ArchetypeStorage;
+	friend class Entity;
+	friend class Pool;
+
+	public:
+		Archetype(const ComponentIdList& indices, const std::vector<const ComponentTypeInfo*>& types);
+		~Archetype();
+
+		auto GetIndices() const -> const ComponentIdList&;
+		bool HasComponent(const ComponentId index) const;
+		bool HasComponents(const ComponentIdList& indices) const;
+		auto GetComponentMask() const -> const ComponentMask&;
+		auto Count() const -> unsigned int;
+		auto GetChunkCount() const -> unsigned int;
+		auto GetChunkCapacity() const -> unsigned int;
+		auto GetChunkRowCount(const unsigned int chunk) const -> unsigned int;
+		auto GetChunkEntities(const unsigned int chunk) const -> Entity* const*;
+		template <typename T> inline auto GetChunkComponents(const unsigned int chunk) const -> T*;
+		auto GetComponent(const ComponentId index, const unsigned int row) const -> IComponent*;
+		auto GetEntity(const unsigned int row) const -> Entity*;
+
+		static const unsigned int ChunkSize = 16 * 1024;
+
+	protected:
+		auto AddRow(Entity* entity) -> unsigned int;
+		auto MoveRow(const unsigned int row, Archetype* target) -> unsigned int;
+		void RemoveRow(const unsigned int row);
+		auto GetMemory(const int column, const unsigned int row) const -> void*;
+		auto GetColumn(const ComponentId index) const -> int;
+
+	private:
+		void CompactRow(const unsigned int row);
+
+		ComponentIdList mIndices;
+		std::vector<const ComponentTypeInfo*> mTypes;
+		std::vector<int> mColumnForIndex;
+		ComponentMask mComponentMask;
+		std::vector<std::size_t> mColumnOffsets;
+		std::vector<char*> mChunks;
+		std::size_t mChunkBytes{0};
+		unsigned int mChunkCapacity{0};
+		unsigned int mCount{0};
+		std::unordered_map<ComponentId, Archetype*> mAddEdges;
+		std::unordered_map<ComponentId, Archetype*> mRemoveEdges;
+};
+
+class JUENGINEAPI ArchetypeStorage
+{
+	public:
+		ArchetypeStorage();
+		~ArchetypeStorage();
+
+		inline void RegisterType(const ComponentId index, const ComponentTypeInfo* type);
+		auto GetType(const ComponentId index) const -> const ComponentTypeInfo*;
+		auto GetRootArchetype() -> Archetype*;
+		auto GetArchetype(const ComponentIdList& indices) -> Archetype*;
+		auto GetArchetypeWith(Archetype* archetype, const ComponentId index) -> Archetype*;
+		auto GetArchetypeWithout(Archetype* archetype, const ComponentId index) -> Archetype*;
+		auto GetArchetypes() const -> const std::vector<Archetype*>&;
+
+	private:
+		std::vector<const ComponentTypeInfo*> mTypes;
+		std::map<ComponentIdList, Archetype*> mArchetypes;
+		std::vector<Archetype*> mArchetypeList;
+};
+
+namespace ComponentTypeInfoImpl
+{
+template <typename T>
+IComponent* ConstructDefault(void* memory)
+{
+	return new (memory) T();
+}
+
+template <typename T>
+IComponent* Construct(void* memory, IComponent* source)
+{
+	return new (memory) T(std::move(*static_cast<T*>(source)));
+}
+
+template <typename T>
+IComponent* Cast(void* memory)
+{
+	return static_cast<T*>(memory);
+}
+
+template <typename T>
+void Swap(IComponent* left, IComponent* right)
+{
+	std::swap(*static_cast<T*>(left), *static_cast<T*>(right));
+}
+
+template <typename T>
+void Copy(IComponent* destination, const IComponent* source)
+{
+	*static_cast<T*>(destination) = *static_cast<const T*>(source);
+}
+
+template <typename T>
+void Destroy(IComponent* component)
+{
+	static_cast<T*>(component)->~T();
+}
+
+template <typename T>
+void Release(IComponent* component)
+{
+	delete static_cast<T*>(component);
+}
+
+// Defined in ComponentArray.hpp
+template <typename T>
+IComponentArray* CreateArray();
+}
+
+template <typename T>
+auto ComponentTypeInfo::Get() -> const ComponentTypeInfo*
+{
+	static const ComponentTypeInfo info = {
+		sizeof(T),
+		alignof(T),
+		&ComponentTypeInfoImpl::ConstructDefault<T>,
+		&ComponentTypeInfoImpl::Construct<T>,
+		&ComponentTypeInfoImpl::Cast<T>,
+		&ComponentTypeInfoImpl::Swap<T>,
+		&ComponentTypeInfoImpl::Copy<T>,
+		&ComponentTypeInfoImpl::Destroy<T>,
+		&ComponentTypeInfoImpl::Release<T>,
+		&ComponentTypeInfoImpl::CreateArray<T>
+	};
+
+	return &info;
+}
+
+template <typename T>
+auto Archetype::GetChunkComponents(const unsigned int chunk) const -> T*
+{
+	auto column = GetColumn(ComponentTypeId::Get<T>());
+
+	if(column < 0)
+	{
+		return nullptr;
+	}
+
+	return reinterpret_cast<T*>(mChunks[chunk] + mColumnOffsets[column]);
+}
+
+void ArchetypeStorage::RegisterType(const ComponentId index, const ComponentTypeInfo* type)
+{
+	if(index >= mTypes.size())
+	{
+		mTypes.resize(index + 1, nullptr);
+	}
+
+	mTypes[index] = type;
+}
+}
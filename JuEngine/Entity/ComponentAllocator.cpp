@@ -0,0 +1,120 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "ComponentAllocator.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <cstddef>
+
+namespace JuEngine
+{
+ComponentAllocator::ComponentAllocator(const ComponentTypeInfo* type) : mType(type)
+{
+	// The pages only have the alignment of operator new
+	if(type->alignment > alignof(std::max_align_t))
+	{
+		ThrowRuntimeError("Error, component type with alignment %u is over-aligned and cannot be stored in a component allocator", (unsigned int) type->alignment);
+	}
+
+	// Free slots store the next free slot
+	auto alignment = std::max(type->alignment, alignof(void*));
+	mSlotSize = ((std::max(type->size, sizeof(void*)) + alignment - 1) / alignment) * alignment;
+	mSlotsPerPage = std::max<unsigned int>(PageSize / mSlotSize, 1);
+}
+
+ComponentAllocator::~ComponentAllocator()
+{
+	if(mCount > 0)
+	{
+		App::Log()->Warning("Warning, %u components remain alive in the component allocator destruction !", mCount);
+	}
+
+	for(auto &page : mPages)
+	{
+		::operator delete(page);
+	}
+}
+
+auto ComponentAllocator::Create() -> IComponent*
+{
+	if(mFreeSlots == nullptr)
+	{
+		AddPage();
+	}
+
+	auto slot = mFreeSlots;
+	mFreeSlots = *static_cast<void**>(slot);
+
+	auto component = mType->constructDefault(slot);
+	mComponentOffset = reinterpret_cast<char*>(component) - static_cast<char*>(slot);
+	++mCount;
+
+	return component;
+}
+
+void ComponentAllocator::Release(IComponent* component)
+{
+	void* slot = reinterpret_cast<char*>(component) - mComponentOffset;
+
+	mType->destroy(component);
+	*static_cast<void**>(slot) = mFreeSlots;
+	mFreeSlots = slot;
+	--mCount;
+}
+
+void ComponentAllocator::ReleasePages()
+{
+	if(mCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot release the pages of the component allocator, %u components are alive", mCount);
+	}
+
+	for(auto &page : mPages)
+	{
+		::operator delete(page);
+	}
+
+	mPages.clear();
+	mFreeSlots = nullptr;
+}
+
+auto ComponentAllocator::GetType() const -> const ComponentTypeInfo*
+{
+	return mType;
+}
+
+auto ComponentAllocator::Count() const -> unsigned int
+{
+	return mCount;
+}
+
+auto ComponentAllocator::GetCapacity() const -> unsigned int
+{
+	return mPages.size() * mSlotsPerPage;
+}
+
+auto ComponentAllocator::GetPageCount() const -> unsigned int
+{
+	return mPages.size();
+}
+
+auto ComponentAllocator::GetMemoryUsage() const -> std::size_t
+{
+	return mPages.size() * mSlotsPerPage * mSlotSize;
+}
+
+void ComponentAllocator::AddPage()
+{
+	auto page = static_cast<char*>(::operator new(mSlotsPerPage * mSlotSize));
+	mPages.push_back(page);
+
+	// The slots are linked backwards so they are used in memory order
+	for(unsigned int slot = mSlotsPerPage; slot-- > 0;)
+	{
+		void* memory = page + slot * mSlotSize;
+		*static_cast<void**>(memory) = mFreeSlots;
+		mFreeSlots = memory;
+	}
+}
+}
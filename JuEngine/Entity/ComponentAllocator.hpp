@@ -0,0 +1,43 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Archetype.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+// Allocates the components of one type in contiguous pages. Released slots are reused (the last
+// released first) and the pages are only freed with ReleasePages, when no component is alive.
+class JUENGINEAPI ComponentAllocator
+{
+	public:
+		ComponentAllocator(const ComponentTypeInfo* type);
+		~ComponentAllocator();
+
+		auto Create() -> IComponent*;
+		void Release(IComponent* component);
+		void ReleasePages();
+
+		auto GetType() const -> const ComponentTypeInfo*;
+		auto Count() const -> unsigned int;
+		auto GetCapacity() const -> unsigned int;
+		auto GetPageCount() const -> unsigned int;
+		auto GetMemoryUsage() const -> std::size_t;
+
+		static const unsigned int PageSize = 16 * 1024;
+
+	private:
+		void AddPage();
+
+		const ComponentTypeInfo* mType;
+		std::size_t mSlotSize{0};
+		unsigned int mSlotsPerPage{0};
+		std::ptrdiff_t mComponentOffset{0};
+		std::vector<char*> mPages;
+		void* mFreeSlots{nullptr};
+		unsigned int mCount{0};
+};
+}
@@ -0,0 +1,56 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "ComponentArray.hpp"
+
+namespace JuEngine
+{
+const unsigned int IComponentArray::InvalidIndex;
+
+IComponentArray::IComponentArray(const ComponentTypeInfo* type) : mType(type)
+{
+}
+
+auto IComponentArray::Count() const -> unsigned int
+{
+	return mDenseEntities.size();
+}
+
+auto IComponentArray::GetEntityIndices() const -> const std::vector<unsigned int>&
+{
+	return mDenseEntities;
+}
+
+auto IComponentArray::GetType() const -> const ComponentTypeInfo*
+{
+	return mType;
+}
+
+auto IComponentArray::InsertIndex(const unsigned int entityIndex) -> unsigned int
+{
+	if(entityIndex >= mSparse.size())
+	{
+		mSparse.resize(entityIndex + 1, InvalidIndex);
+	}
+
+	mSparse[entityIndex] = mDenseEntities.size();
+	mDenseEntities.push_back(entityIndex);
+
+	return mSparse[entityIndex];
+}
+
+auto IComponentArray::EraseIndex(const unsigned int entityIndex) -> unsigned int
+{
+	auto position = mSparse[entityIndex];
+	auto lastEntityIndex = mDenseEntities.back();
+
+	// Swap with the last element to keep the dense array packed
+	mDenseEntities[position] = lastEntityIndex;
+	mSparse[lastEntityIndex] = position;
+	mDenseEntities.pop_back();
+	mSparse[entityIndex] = InvalidIndex;
+
+	return position;
+}
+}
@@ -0,0 +1,107 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Archetype.hpp"
+#include <limits>
+
+namespace JuEngine
+{
+class JUENGINEAPI IComponentArray
+{
+	public:
+		IComponentArray(const ComponentTypeInfo* type);
+		virtual ~IComponentArray() = default;
+
+		inline bool Has(const unsigned int entityIndex) const;
+		auto Count() const -> unsigned int;
+		auto GetEntityIndices() const -> const std::vector<unsigned int>&;
+		auto GetType() const -> const ComponentTypeInfo*;
+
+		virtual auto GetComponent(const unsigned int entityIndex) -> IComponent* = 0;
+		virtual auto Insert(const unsigned int entityIndex, IComponent* source) -> IComponent* = 0;
+		virtual void Erase(const unsigned int entityIndex) = 0;
+
+		static const unsigned int InvalidIndex = std::numeric_limits<unsigned int>::max();
+
+	protected:
+		auto InsertIndex(const unsigned int entityIndex) -> unsigned int;
+		auto EraseIndex(const unsigned int entityIndex) -> unsigned int;
+
+		std::vector<unsigned int> mSparse;
+		std::vector<unsigned int> mDenseEntities;
+		const ComponentTypeInfo* mType;
+};
+
+template <typename T>
+class ComponentArray : public IComponentArray
+{
+	public:
+		ComponentArray() : IComponentArray(ComponentTypeInfo::Get<T>()) {}
+
+		inline auto Get(const unsigned int entityIndex) -> T*;
+		auto GetData() -> T*;
+		auto GetComponent(const unsigned int entityIndex) -> IComponent*;
+		auto Insert(const unsigned int entityIndex, IComponent* source) -> IComponent*;
+		void Erase(const unsigned int entityIndex);
+
+	private:
+		std::vector<T> mComponents;
+};
+
+bool IComponentArray::Has(const unsigned int entityIndex) const
+{
+	return entityIndex < mSparse.size() && mSparse[entityIndex] != InvalidIndex;
+}
+
+template <typename T>
+auto ComponentArray<T>::Get(const unsigned int entityIndex) -> T*
+{
+	return &mComponents[mSparse[entityIndex]];
+}
+
+template <typename T>
+auto ComponentArray<T>::GetData() -> T*
+{
+	return mComponents.data();
+}
+
+template <typename T>
+auto ComponentArray<T>::GetComponent(const unsigned int entityIndex) -> IComponent*
+{
+	return Get(entityIndex);
+}
+
+template <typename T>
+auto ComponentArray<T>::Insert(const unsigned int entityIndex, IComponent* source) -> IComponent*
+{
+	InsertIndex(entityIndex);
+	mComponents.emplace_back(std::move(*static_cast<T*>(source)));
+
+	return &mComponents.back();
+}
+
+template <typename T>
+void ComponentArray<T>::Erase(const unsigned int entityIndex)
+{
+	auto position = EraseIndex(entityIndex);
+
+	if(position != mComponents.size() - 1)
+	{
+		mComponents[position] = std::move(mComponents.back());
+	}
+
+	mComponents.pop_back();
+}
+
+namespace ComponentTypeInfoImpl
+{
+template <typename T>
+IComponentArray* CreateArray()
+{
+	return new ComponentArray<T>();
+}
+}
+}
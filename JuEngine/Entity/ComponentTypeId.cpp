@@ -3,8 +3,47 @@
 // GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
 
 #include "ComponentTypeId.hpp"
+#include "../App.hpp"
 
 namespace JuEngine
 {
-unsigned int ComponentTypeId::mCounter = 0;
+unsigned int ComponentTypeId::mCounter = JUENGINE_STATIC_COMPONENTS;
+
+auto ComponentTypeId::GetMask(const ComponentIdList& indices) -> ComponentMask
+{
+	ComponentMask mask;
+
+	for(const auto &index : indices)
+	{
+		mask.set(index);
+	}
+
+	return mask;
+}
+
+auto ComponentTypeId::GetIndices(const ComponentMask& mask) -> ComponentIdList
+{
+	ComponentIdList indices;
+	indices.reserve(mask.count());
+
+	for(ComponentId index = 0; index < mask.size(); ++index)
+	{
+		if(mask[index])
+		{
+			indices.push_back(index);
+		}
+	}
+
+	return indices;
+}
+
+auto ComponentTypeId::Next() -> ComponentId
+{
+	if(mCounter >= JUENGINE_MAX_COMPONENTS)
+	{
+		ThrowRuntimeError("Error, too many component types. Increase JUENGINE_MAX_COMPONENTS (current value: %u)", JUENGINE_MAX_COMPONENTS);
+	}
+
+	return mCounter++;
+}
 }
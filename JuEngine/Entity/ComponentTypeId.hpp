@@ -6,22 +6,68 @@
 
 #include "IComponent.hpp"
 #include <vector>
+#include <bitset>
+#include <type_traits>
+
+// Maximum number of component types, it must have the same value in the engine and in the game
+#ifndef JUENGINE_MAX_COMPONENTS
+	#define JUENGINE_MAX_COMPONENTS 64
+#endif
+
+// Number of ids reserved for the components with a static id (see JUENGINE_COMPONENT_ID), the
+// other component types get the next ids in order of first use. Static ids are opt-in: none are
+// reserved by default, define it (e.g. as JUENGINE_MAX_COMPONENTS / 2) in the engine and the game
+#ifndef JUENGINE_STATIC_COMPONENTS
+	#define JUENGINE_STATIC_COMPONENTS 0
+#endif
+
+// Gives a component type a fixed id, known at compile time and stable between builds and runs
+// (it must be used in the global namespace, after the component declaration)
+#define JUENGINE_COMPONENT_ID(COMPONENT_CLASS, ID) \
+	namespace JuEngine \
+	{ \
+	template <> \
+	struct StaticComponentId<COMPONENT_CLASS> \
+	{ \
+		static_assert(ID < JUENGINE_STATIC_COMPONENTS, "Static component ids must be lower than JUENGINE_STATIC_COMPONENTS (define it to reserve the static ids)"); \
+		static const bool IsDefined = true; \
+		static const ComponentId Value = ID; \
+	}; \
+	}
 
 namespace JuEngine
 {
 typedef unsigned int ComponentId;
 typedef std::vector<ComponentId> ComponentIdList;
+typedef std::bitset<JUENGINE_MAX_COMPONENTS> ComponentMask;
+
+static_assert(JUENGINE_STATIC_COMPONENTS <= JUENGINE_MAX_COMPONENTS, "JUENGINE_STATIC_COMPONENTS can't be greater than JUENGINE_MAX_COMPONENTS");
+
+template <typename T>
+struct StaticComponentId
+{
+	static const bool IsDefined = false;
+};
 
 struct JUENGINEAPI ComponentTypeId
 {
 	public:
 		template<typename T>
-		static const ComponentId Get()
+		static constexpr auto Get() -> typename std::enable_if<StaticComponentId<T>::IsDefined, ComponentId>::type
+		{
+			static_assert((std::is_base_of<IComponent, T>::value && ! std::is_same<IComponent, T>::value),
+				"Class type must be derived from IComponent");
+
+			return StaticComponentId<T>::Value;
+		}
+
+		template<typename T>
+		static auto Get() -> typename std::enable_if<! StaticComponentId<T>::IsDefined, ComponentId>::type
 		{
 			static_assert((std::is_base_of<IComponent, T>::value && ! std::is_same<IComponent, T>::value),
 				"Class type must be derived from IComponent");
 
-			static ComponentId id = mCounter++;
+			static ComponentId id = Next();
 			return id;
 		}
 
@@ -30,7 +76,12 @@ struct JUENGINEAPI ComponentTypeId
 			return mCounter;
 		}
 
+		static auto GetMask(const ComponentIdList& indices) -> ComponentMask;
+		static auto GetIndices(const ComponentMask& mask) -> ComponentIdList;
+
 	private:
+		static auto Next() -> ComponentId;
+
 		static unsigned int mCounter;
 };
 }
@@ -3,30 +3,50 @@
 // GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
 
 #include "Entity.hpp"
+#include "Pool.hpp"
 #include "../App.hpp"
+#include <algorithm>
 
 namespace JuEngine
 {
-Entity::Entity(std::map<ComponentId, std::stack<IComponent*>>* componentPools) : IObject("e")
+// Every entity belongs to a pool, the pool is never checked again after this
+Entity::Entity(Pool* pool, std::map<ComponentId, std::stack<IComponent*>>* componentPools, ArchetypeStorage* archetypeStorage, std::vector<IComponentArray*>* componentArrays) : IObject("e")
 {
+	if(pool == nullptr)
+	{
+		ThrowRuntimeError("Error, cannot create an entity without a pool");
+	}
+
+	mPool = pool;
 	mComponentPools = componentPools;
+	mArchetypeStorage = archetypeStorage;
+	mComponentArrays = componentArrays;
 }
 
 auto Entity::AddComponent(const ComponentId index, IComponent* component) -> EntityPtr
 {
 	if (! mIsEnabled)
 	{
+		DiscardComponent(index, component);
 		ThrowRuntimeError("Error, cannot add component to entity (%u), entity has already been destroyed.", mUuid);
 	}
 
+	if (mPool->mLockCount > 0)
+	{
+		DiscardComponent(index, component);
+		ThrowRuntimeError("Error, cannot add component to entity (%u), the pool is being iterated in parallel. Use the command buffer instead.", mUuid);
+	}
+
 	if (HasComponent(index))
 	{
+		DiscardComponent(index, component);
 		ThrowRuntimeError("Error, cannot add component to entity (%u), component already exists at index %u", mUuid, index);
 	}
 
-	mComponents[index] = component;
+	mComponentMask.set(index);
+	component = InsertComponent(index, component);
 
-	OnComponentAdded(mInstance.lock(), index, component);
+	NotifyComponentAdded(index, component);
 
 	return mInstance.lock();
 }
@@ -38,6 +58,11 @@ auto Entity::RemoveComponent(const ComponentId index) -> EntityPtr
 		ThrowRuntimeError("Error, cannot remove component to entity (%u), entity has already been destroyed.", mUuid);
 	}
 
+	if (mPool->mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot remove component to entity (%u), the pool is being iterated in parallel. Use the command buffer instead.", mUuid);
+	}
+
 	if (! HasComponent(index))
 	{
 		ThrowRuntimeError("Error, cannot remove component to entity (%u), component not exists at index %u", mUuid, index);
@@ -52,9 +77,16 @@ auto Entity::ReplaceComponent(const ComponentId index, IComponent* component) ->
 {
 	if (! mIsEnabled)
 	{
+		DiscardComponent(index, component);
 		ThrowRuntimeError("Error, cannot replace component to entity (%u), entity has already been destroyed.", mUuid);
 	}
 
+	if (mPool->mLockCount > 0)
+	{
+		DiscardComponent(index, component);
+		ThrowRuntimeError("Error, cannot replace component to entity (%u), the pool is being iterated in parallel. Use the command buffer instead.", mUuid);
+	}
+
 	if (HasComponent(index))
 	{
 		Replace(index, component);
@@ -74,12 +106,21 @@ auto Entity::GetComponent(const ComponentId index) const -> IComponent*
 		ThrowRuntimeError("Error, cannot get component from entity (%u), component not exists at index %u", mUuid, index);
 	}
 
+	if(mArchetypeStorage != nullptr)
+	{
+		return mArchetype->GetComponent(index, mRow);
+	}
+	else if(mComponentArrays != nullptr)
+	{
+		return (*mComponentArrays)[index]->GetComponent(mIndex);
+	}
+
 	return mComponents.at(index);
 }
 
 bool Entity::HasComponent(const ComponentId index) const
 {
-	return (mComponents.find(index) != mComponents.end());
+	return mComponentMask[index];
 }
 
 bool Entity::HasComponents(const std::vector<ComponentId>& indices) const
@@ -108,25 +149,26 @@ bool Entity::HasAnyComponent(const std::vector<ComponentId>& indices) const
 	return false;
 }
 
+auto Entity::GetComponentMask() const -> const ComponentMask&
+{
+	return mComponentMask;
+}
+
 auto Entity::GetComponentsCount() const -> unsigned int
 {
-	return mComponents.size();
+	return mComponentMask.count();
 }
 
 void Entity::RemoveAllComponents()
 {
+	while(mComponentMask.any())
 	{
-		auto componentsIdTemp = std::vector<ComponentId>(mComponents.size());
-
-		for(const auto &pair : mComponents)
+		for(ComponentId index = mComponentMask.size(); index-- > 0;)
 		{
-			componentsIdTemp.push_back(pair.first);
-		}
-
-		while(! mComponents.empty())
-		{
-			Replace(componentsIdTemp.back(), nullptr);
-			componentsIdTemp.pop_back();
+			if(mComponentMask[index])
+			{
+				Replace(index, nullptr);
+			}
 		}
 	}
 }
@@ -136,6 +178,16 @@ auto Entity::GetUuid() const -> const unsigned int
 	return mUuid;
 }
 
+auto Entity::GetIndex() const -> unsigned int
+{
+	return mIndex;
+}
+
+auto Entity::GetId() const -> EntityId
+{
+	return EntityId(mIndex, mVersion);
+}
+
 bool Entity::IsEnabled()
 {
 	return mIsEnabled;
@@ -163,6 +215,12 @@ void Entity::Destroy()
 	OnComponentReplaced.Clear();
 	OnComponentRemoved.Clear();
 	mIsEnabled = false;
+
+	if(mArchetype != nullptr)
+	{
+		mArchetype->RemoveRow(mRow);
+		mArchetype = nullptr;
+	}
 }
 
 auto Entity::GetComponentPool(const ComponentId index) const -> std::stack<IComponent*>*
@@ -170,28 +228,204 @@ auto Entity::GetComponentPool(const ComponentId index) const -> std::stack<IComp
 	return &((*mComponentPools)[index]);
 }
 
+auto Entity::GetPooledComponent(const ComponentId index) const -> IComponent*
+{
+	auto componentPool = GetComponentPool(index);
+
+	if(componentPool->size() > 0)
+	{
+		auto component = componentPool->top();
+		componentPool->pop();
+
+		return component;
+	}
+
+	return mPool->mComponentAllocators[index]->Create();
+}
+
+// The component pools are shared by every entity of the pool, they can't be touched while iterating in parallel
+void Entity::CheckPoolUnlocked() const
+{
+	if (mPool->mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot create component for entity (%u), the pool is being iterated in parallel. Use the command buffer instead.", mUuid);
+	}
+}
+
+// The pool is notified directly, the public events only cost something when they are used
+void Entity::NotifyComponentAdded(const ComponentId index, IComponent* component)
+{
+	auto instance = mInstance.lock();
+
+	mPool->UpdateGroupsComponentAddedOrRemoved(instance, index, component);
+	OnComponentAdded(instance, index, component);
+}
+
+void Entity::NotifyComponentRemoved(const ComponentId index, IComponent* component)
+{
+	auto instance = mInstance.lock();
+
+	mPool->UpdateGroupsComponentAddedOrRemoved(instance, index, component);
+	OnComponentRemoved(instance, index, component);
+}
+
+void Entity::NotifyComponentReplaced(const ComponentId index, IComponent* previousComponent, IComponent* newComponent)
+{
+	auto instance = mInstance.lock();
+
+	mPool->UpdateGroupsComponentReplaced(instance, index, previousComponent, newComponent);
+	OnComponentReplaced(instance, index, previousComponent, newComponent);
+}
+
+void Entity::RegisterComponentType(const ComponentId index, const ComponentTypeInfo* type)
+{
+	mPool->RegisterComponentType(index, type);
+}
+
+auto Entity::GetComponentType(const ComponentId index) const -> const ComponentTypeInfo*
+{
+	return mPool->GetComponentType(index);
+}
+
+// The component created for a rejected change returns to the pool
+void Entity::DiscardComponent(const ComponentId index, IComponent* component)
+{
+	if(component != nullptr && ! (HasComponent(index) && GetComponent(index) == component))
+	{
+		GetComponentPool(index)->push(component);
+	}
+}
+
+auto Entity::InsertComponent(const ComponentId index, IComponent* component) -> IComponent*
+{
+	if(mArchetypeStorage == nullptr && mComponentArrays == nullptr)
+	{
+		mComponents[index] = component;
+
+		return component;
+	}
+
+	IComponent* storedComponent = nullptr;
+
+	if(mArchetypeStorage != nullptr)
+	{
+		auto archetype = mArchetypeStorage->GetArchetypeWith(mArchetype, index);
+		mRow = mArchetype->MoveRow(mRow, archetype);
+		mArchetype = archetype;
+
+		storedComponent = mArchetypeStorage->GetType(index)->construct(mArchetype->GetMemory(mArchetype->GetColumn(index), mRow), component);
+	}
+	else
+	{
+		storedComponent = (*mComponentArrays)[index]->Insert(mIndex, component);
+	}
+
+	// The component data is moved into the storage, the object returns to the pool
+	GetComponentPool(index)->push(component);
+
+	return storedComponent;
+}
+
+// The entity moves once to its final storage, the pool notifies the groups afterwards
+void Entity::InsertComponents(const ComponentIdList& indices, IComponent* const* components)
+{
+	if(mArchetypeStorage == nullptr)
+	{
+		for(unsigned int i = 0, count = indices.size(); i < count; ++i)
+		{
+			mComponentMask.set(indices[i]);
+			InsertComponent(indices[i], components[i]);
+		}
+
+		return;
+	}
+
+	ComponentIdList archetypeIndices = mArchetype->GetIndices();
+
+	for(const auto &index : indices)
+	{
+		mComponentMask.set(index);
+		archetypeIndices.insert(std::upper_bound(archetypeIndices.begin(), archetypeIndices.end(), index), index);
+	}
+
+	auto archetype = mArchetypeStorage->GetArchetype(archetypeIndices);
+	mRow = mArchetype->MoveRow(mRow, archetype);
+	mArchetype = archetype;
+
+	for(unsigned int i = 0, count = indices.size(); i < count; ++i)
+	{
+		GetComponentType(indices[i])->construct(mArchetype->GetMemory(mArchetype->GetColumn(indices[i]), mRow), components[i]);
+		GetComponentPool(indices[i])->push(components[i]);
+	}
+}
+
+// Removes the component without notifying, the returned object keeps the data for the listeners
+auto Entity::DetachComponent(const ComponentId index) -> IComponent*
+{
+	auto previousComponent = GetComponent(index);
+
+	mComponentMask.reset(index);
+
+	if(mArchetypeStorage != nullptr || mComponentArrays != nullptr)
+	{
+		auto component = GetPooledComponent(index);
+		GetComponentType(index)->swap(component, previousComponent);
+		EraseComponent(index);
+		GetComponentPool(index)->push(component);
+
+		return component;
+	}
+
+	mComponents.erase(index);
+	GetComponentPool(index)->push(previousComponent);
+
+	return previousComponent;
+}
+
+void Entity::EraseComponent(const ComponentId index)
+{
+	if(mArchetypeStorage != nullptr)
+	{
+		auto archetype = mArchetypeStorage->GetArchetypeWithout(mArchetype, index);
+		mRow = mArchetype->MoveRow(mRow, archetype);
+		mArchetype = archetype;
+	}
+	else
+	{
+		(*mComponentArrays)[index]->Erase(mIndex);
+	}
+}
+
 void Entity::Replace(const ComponentId index, IComponent* replacement)
 {
+	if(replacement == nullptr)
+	{
+		NotifyComponentRemoved(index, DetachComponent(index));
+
+		return;
+	}
+
 	auto previousComponent = GetComponent(index);
 
 	if(previousComponent == replacement)
 	{
-		OnComponentReplaced(mInstance.lock(), index, previousComponent, replacement);
+		NotifyComponentReplaced(index, previousComponent, replacement);
+	}
+	else if(mArchetypeStorage != nullptr || mComponentArrays != nullptr)
+	{
+		// Stored components are reused in place, the previous data is swapped out into a pooled object
+		// so the listeners receive a pointer that remains valid like in the default storage mode
+		GetComponentType(index)->swap(replacement, previousComponent);
+
+		GetComponentPool(index)->push(replacement);
+		NotifyComponentReplaced(index, replacement, previousComponent);
 	}
 	else
 	{
 		GetComponentPool(index)->push(previousComponent);
 
-		if(replacement == nullptr)
-		{
-			mComponents.erase(index);
-			OnComponentRemoved(mInstance.lock(), index, previousComponent);
-		}
-		else
-		{
-			mComponents[index] = replacement;
-			OnComponentReplaced(mInstance.lock(), index, previousComponent, replacement);
-		}
+		mComponents[index] = replacement;
+		NotifyComponentReplaced(index, previousComponent, replacement);
 	}
 }
 }
@@ -4,7 +4,9 @@
 
 #pragma once
 
+#include "ComponentArray.hpp"
 #include "ComponentTypeId.hpp"
+#include "EntityId.hpp"
 #include "../Resources/Delegate.hpp"
 #include "../Resources/IObject.hpp"
 #include <stack>
@@ -13,14 +15,17 @@
 namespace JuEngine
 {
 class Entity;
+class Pool;
 typedef std::shared_ptr<Entity> EntityPtr;
 
 class JUENGINEAPI Entity : public IObject
 {
 	friend class Pool;
+	friend class Archetype;
+	friend class EntityCommandBuffer;
 
 	public:
-		Entity(std::map<ComponentId, std::stack<IComponent*>>* componentPools);
+		Entity(Pool* pool, std::map<ComponentId, std::stack<IComponent*>>* componentPools, ArchetypeStorage* archetypeStorage = nullptr, std::vector<IComponentArray*>* componentArrays = nullptr);
 
 		template <typename T, typename... TArgs> inline auto Add(TArgs&&... args) -> EntityPtr;
 		template <typename T> inline auto Remove() -> EntityPtr;
@@ -32,17 +37,20 @@ class JUENGINEAPI Entity : public IObject
 
 		bool HasComponents(const std::vector<ComponentId>& indices) const;
 		bool HasAnyComponent(const std::vector<ComponentId>& indices) const;
+		auto GetComponentMask() const -> const ComponentMask&;
 		auto GetComponentsCount() const -> unsigned int;
 		void RemoveAllComponents();
 		auto GetUuid() const -> const unsigned int;
+		auto GetIndex() const -> unsigned int;
+		auto GetId() const -> EntityId;
 		bool IsEnabled();
 
 		bool operator ==(const EntityPtr& right) const;
 		bool operator ==(const Entity right) const;
 
-		using EntityChanged = Delegate<void(EntityPtr entity, ComponentId index, IComponent* component)>;
-		using ComponentReplaced = Delegate<void(EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)>;
-		using EntityReleased = Delegate<void(Entity* entity)>;
+		using EntityChanged = Delegate<void(EntityPtr entity, ComponentId index, IComponent* component), DelegateNoLock>;
+		using ComponentReplaced = Delegate<void(EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent), DelegateNoLock>;
+		using EntityReleased = Delegate<void(Entity* entity), DelegateNoLock>;
 
 		EntityChanged OnComponentAdded;
 		ComponentReplaced OnComponentReplaced;
@@ -59,40 +67,59 @@ class JUENGINEAPI Entity : public IObject
 		void Destroy();
 
 		template <typename T, typename... TArgs> inline auto CreateComponent(TArgs&&... args) -> IComponent*;
+		template <typename T> inline auto AcquireComponent() -> IComponent*;
 
 		unsigned int mUuid{0};
 		bool mIsEnabled = true;
 
 	private:
 		auto GetComponentPool(const ComponentId index) const -> std::stack<IComponent*>*;
+		auto GetPooledComponent(const ComponentId index) const -> IComponent*;
+		void CheckPoolUnlocked() const;
+		void NotifyComponentAdded(const ComponentId index, IComponent* component);
+		void NotifyComponentRemoved(const ComponentId index, IComponent* component);
+		void NotifyComponentReplaced(const ComponentId index, IComponent* previousComponent, IComponent* newComponent);
+		void RegisterComponentType(const ComponentId index, const ComponentTypeInfo* type);
+		auto GetComponentType(const ComponentId index) const -> const ComponentTypeInfo*;
+		auto InsertComponent(const ComponentId index, IComponent* component) -> IComponent*;
+		void InsertComponents(const ComponentIdList& indices, IComponent* const* components);
+		auto DetachComponent(const ComponentId index) -> IComponent*;
+		void DiscardComponent(const ComponentId index, IComponent* component);
+		void EraseComponent(const ComponentId index);
 		void Replace(const ComponentId index, IComponent* replacement);
 
 		std::weak_ptr<Entity> mInstance;
+		Pool* mPool{nullptr};
 		std::map<ComponentId, IComponent*> mComponents;
+		ComponentMask mComponentMask;
 		std::map<ComponentId, std::stack<IComponent*>>* mComponentPools;
+		ArchetypeStorage* mArchetypeStorage{nullptr};
+		Archetype* mArchetype{nullptr};
+		unsigned int mRow{0};
+		std::vector<IComponentArray*>* mComponentArrays{nullptr};
+		unsigned int mIndex{0};
+		std::uint32_t mVersion{1};
 };
 
 template <typename T, typename... TArgs>
 auto Entity::CreateComponent(TArgs&&... args) -> IComponent*
 {
-	std::stack<IComponent*>* componentPool = GetComponentPool(ComponentTypeId::Get<T>());
-	IComponent* component = nullptr;
-
-	if(componentPool->size() > 0)
-	{
-		component = componentPool->top();
-		componentPool->pop();
-	}
-	else
-	{
-		component = new T();
-	}
+	IComponent* component = AcquireComponent<T>();
 
 	(static_cast<T*>(component))->Reset(std::forward<TArgs>(args)...);
 
 	return component;
 }
 
+template <typename T>
+auto Entity::AcquireComponent() -> IComponent*
+{
+	CheckPoolUnlocked();
+	RegisterComponentType(ComponentTypeId::Get<T>(), ComponentTypeInfo::Get<T>());
+
+	return GetPooledComponent(ComponentTypeId::Get<T>());
+}
+
 template <typename T, typename... TArgs>
 auto Entity::Add(TArgs&&... args) -> EntityPtr
 {
@@ -144,7 +171,9 @@ struct hash<weak_ptr<JuEngine::Entity>>
 {
 	std::size_t operator()(const weak_ptr<JuEngine::Entity>& ptr) const
 	{
-		return hash<unsigned int>()(ptr.lock()->GetUuid());
+		auto entity = ptr.lock();
+
+		return entity != nullptr ? hash<unsigned int>()(entity->GetUuid()) : 0;
 	}
 };
 
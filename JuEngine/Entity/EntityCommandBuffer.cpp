@@ -0,0 +1,307 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "EntityCommandBuffer.hpp"
+#include "Pool.hpp"
+#include "../App.hpp"
+#include <algorithm>
+
+namespace JuEngine
+{
+EntityCommandBuffer::EntityCommandBuffer(Pool* pool) : mPool(pool)
+{
+}
+
+EntityCommandBuffer::~EntityCommandBuffer()
+{
+	Clear();
+
+	for(auto &pair : mComponentPools)
+	{
+		auto type = mComponentTypes.at(pair.first);
+
+		while(! pair.second.empty())
+		{
+			type->release(pair.second.top());
+			pair.second.pop();
+		}
+	}
+}
+
+auto EntityCommandBuffer::CreateEntity() -> EntityId
+{
+	// Deferred entities use the version 0 (never valid in a pool)
+	return EntityId(mCreatedCount++, 0);
+}
+
+void EntityCommandBuffer::DestroyEntity(const EntityId id)
+{
+	Record(CommandType::Destroy, id, 0, nullptr, nullptr);
+}
+
+void EntityCommandBuffer::Playback()
+{
+	if(mPool->mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot play back the command buffer, the pool is being iterated in parallel.");
+	}
+
+	// If a change is rejected the remaining commands are dropped, so the buffer can be reused
+	try
+	{
+		ApplyCommands();
+	}
+	catch(...)
+	{
+		Clear();
+		throw;
+	}
+
+	mCommands.clear();
+	mCreatedEntities.clear();
+	mCreatedCount = 0;
+}
+
+void EntityCommandBuffer::ApplyCommands()
+{
+	mOrder.clear();
+
+	// Entities are created first so the commands can target them
+	mCreatedEntities.reserve(mCreatedCount);
+
+	for(unsigned int i = 0; i < mCreatedCount; ++i)
+	{
+		mCreatedEntities.push_back(mPool->CreateEntity());
+	}
+
+	for(unsigned int i = 0, commandCount = mCommands.size(); i < commandCount; ++i)
+	{
+		const auto &id = mCommands[i].entity;
+
+		mOrder.push_back(std::make_pair(id.version == 0 ? mCreatedEntities[id.index]->GetId() : id, i));
+	}
+
+	// Group the commands by entity keeping the recording order for each one
+	std::stable_sort(mOrder.begin(), mOrder.end(), [](const std::pair<EntityId, unsigned int>& left, const std::pair<EntityId, unsigned int>& right)
+	{
+		return left.first.index < right.first.index || (left.first.index == right.first.index && left.first.version < right.first.version);
+	});
+
+	for(unsigned int first = 0, orderCount = mOrder.size(); first < orderCount;)
+	{
+		auto last = first;
+		mCommandIndices.clear();
+
+		while(last < orderCount && mOrder[last].first == mOrder[first].first)
+		{
+			mCommandIndices.push_back(mOrder[last].second);
+			++last;
+		}
+
+		// The listeners of the previous entities can destroy this one (and reuse its object), so
+		// the handle is resolved right before its commands are applied
+		auto entity = mPool->GetEntity(mOrder[first].first);
+
+		if(entity == nullptr)
+		{
+			for(const auto &commandIndex : mCommandIndices)
+			{
+				UnstageComponent(mCommands[commandIndex]);
+			}
+		}
+		else
+		{
+			ApplyEntityCommands(entity);
+		}
+
+		first = last;
+	}
+}
+
+void EntityCommandBuffer::Clear()
+{
+	for(auto &command : mCommands)
+	{
+		UnstageComponent(command);
+	}
+
+	mCommands.clear();
+	mCreatedEntities.clear();
+	mCreatedCount = 0;
+}
+
+bool EntityCommandBuffer::IsEmpty() const
+{
+	return mCommands.empty() && mCreatedCount == 0;
+}
+
+auto EntityCommandBuffer::GetPool() const -> Pool*
+{
+	return mPool;
+}
+
+void EntityCommandBuffer::Record(const CommandType type, const EntityId id, const ComponentId index, IComponent* component, IComponent* (*apply)(Entity*, IComponent*))
+{
+	if(id.version == 0 && id.index >= mCreatedCount)
+	{
+		if(component != nullptr)
+		{
+			mComponentPools[index].push(component);
+		}
+
+		ThrowRuntimeError("Error, cannot record command for entity (index %u). The entity was not created by this command buffer.", id.index);
+	}
+
+	mCommands.push_back({ type, id, index, component, apply });
+}
+
+void EntityCommandBuffer::ApplyEntityCommands(Entity* entity)
+{
+	const unsigned int count = mCommandIndices.size();
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		if(mCommands[mCommandIndices[i]].type == CommandType::Destroy)
+		{
+			for(unsigned int j = 0; j < count; ++j)
+			{
+				UnstageComponent(mCommands[mCommandIndices[j]]);
+			}
+
+			mPool->DestroyEntity(entity->GetId());
+
+			return;
+		}
+	}
+
+	mAddedCommands.clear();
+	mReplacedCommands.clear();
+	mChangedIndices.clear();
+	mChangedComponents.clear();
+
+	// The net change of every component is found first, a rejected change leaves the entity untouched
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		auto &command = mCommands[mCommandIndices[i]];
+		bool removed = false;
+		bool overridden = false;
+
+		for(unsigned int j = 0; j < count; ++j)
+		{
+			const auto &other = mCommands[mCommandIndices[j]];
+
+			if(other.index == command.index)
+			{
+				removed = removed || (j < i && other.type == CommandType::Remove);
+				overridden = overridden || (j > i);
+			}
+		}
+
+		// Only the last change of each component is applied
+		if(overridden)
+		{
+			UnstageComponent(command);
+			continue;
+		}
+
+		bool hasComponent = entity->HasComponent(command.index);
+
+		if(command.type == CommandType::Remove)
+		{
+			if(hasComponent)
+			{
+				mChangedIndices.push_back(command.index);
+			}
+		}
+		else if(hasComponent && command.type == CommandType::Add && ! removed)
+		{
+			ThrowRuntimeError("Error, cannot add component to entity (%u), component already exists at index %u", entity->GetUuid(), command.index);
+		}
+		else if(hasComponent)
+		{
+			mReplacedCommands.push_back(mCommandIndices[i]);
+		}
+		else
+		{
+			mAddedCommands.push_back(mCommandIndices[i]);
+		}
+	}
+
+	auto instance = entity->mInstance.lock();
+	unsigned int removedCount = mChangedIndices.size();
+
+	// The components are added and removed without notifying, then the groups handle the entity once
+	for(unsigned int i = 0; i < removedCount; ++i)
+	{
+		mChangedComponents.push_back(entity->DetachComponent(mChangedIndices[i]));
+	}
+
+	if(! mAddedCommands.empty())
+	{
+		mAddedIndices.clear();
+		mAddedComponents.clear();
+
+		for(const auto &commandIndex : mAddedCommands)
+		{
+			auto &command = mCommands[commandIndex];
+
+			mAddedIndices.push_back(command.index);
+			mAddedComponents.push_back(command.apply(entity, command.component));
+			UnstageComponent(command);
+		}
+
+		entity->InsertComponents(mAddedIndices, mAddedComponents.data());
+
+		for(const auto &index : mAddedIndices)
+		{
+			mChangedIndices.push_back(index);
+			mChangedComponents.push_back(entity->GetComponent(index));
+		}
+	}
+
+	if(! mChangedIndices.empty())
+	{
+		mPool->UpdateGroupsComponentsAddedOrRemoved(instance, mChangedIndices, mChangedComponents.data());
+	}
+
+	for(unsigned int i = 0, changedCount = mChangedIndices.size(); i < changedCount; ++i)
+	{
+		if(i < removedCount)
+		{
+			entity->OnComponentRemoved(instance, mChangedIndices[i], mChangedComponents[i]);
+		}
+		else
+		{
+			entity->OnComponentAdded(instance, mChangedIndices[i], mChangedComponents[i]);
+		}
+	}
+
+	// A replaced component doesn't change the groups of the entity, but a listener could destroy it
+	for(const auto &commandIndex : mReplacedCommands)
+	{
+		auto &command = mCommands[commandIndex];
+
+		if(! entity->IsEnabled())
+		{
+			UnstageComponent(command);
+			continue;
+		}
+
+		auto component = command.apply(entity, command.component);
+		UnstageComponent(command);
+
+		entity->ReplaceComponent(command.index, component);
+	}
+}
+
+// The staged object returns to the buffer only once, the command forgets it
+void EntityCommandBuffer::UnstageComponent(Command& command)
+{
+	if(command.component != nullptr)
+	{
+		mComponentPools[command.index].push(command.component);
+		command.component = nullptr;
+	}
+}
+}
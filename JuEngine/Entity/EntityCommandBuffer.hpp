@@ -0,0 +1,133 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../DllExport.hpp"
+#include "Entity.hpp"
+#include <map>
+#include <stack>
+#include <vector>
+
+namespace JuEngine
+{
+class Pool;
+
+// Records structural changes to apply them later (Playback) in one batch. The changes of each
+// entity are applied together and the redundant ones are dropped (only the last change of a
+// component counts and nothing is applied to an entity that gets destroyed). The groups handle
+// each changed entity once, whatever the number of components added or removed.
+class JUENGINEAPI EntityCommandBuffer
+{
+	public:
+		EntityCommandBuffer(Pool* pool);
+		~EntityCommandBuffer();
+
+		EntityCommandBuffer(const EntityCommandBuffer&) = delete;
+		EntityCommandBuffer& operator =(const EntityCommandBuffer&) = delete;
+
+		// The returned handle is only valid for this buffer, the entity is created in the playback
+		auto CreateEntity() -> EntityId;
+		void DestroyEntity(const EntityId id);
+		template <typename T, typename... TArgs> inline void Add(const EntityId id, TArgs&&... args);
+		template <typename T> inline void Remove(const EntityId id);
+		template <typename T, typename... TArgs> inline void Replace(const EntityId id, TArgs&&... args);
+
+		void Playback();
+		void Clear();
+		bool IsEmpty() const;
+		auto GetPool() const -> Pool*;
+
+	private:
+		enum class CommandType
+		{
+			Destroy,
+			Add,
+			Remove,
+			Replace
+		};
+
+		struct Command
+		{
+			CommandType type;
+			EntityId entity;
+			ComponentId index;
+			IComponent* component;
+			IComponent* (*apply)(Entity* entity, IComponent* component);
+		};
+
+		template <typename T, typename... TArgs> inline auto StageComponent(TArgs&&... args) -> IComponent*;
+		template <typename T> static auto ApplyComponent(Entity* entity, IComponent* component) -> IComponent*;
+		void Record(const CommandType type, const EntityId id, const ComponentId index, IComponent* component, IComponent* (*apply)(Entity*, IComponent*));
+		void ApplyCommands();
+		void ApplyEntityCommands(Entity* entity);
+		void UnstageComponent(Command& command);
+
+		Pool* mPool;
+		unsigned int mCreatedCount{0};
+		std::vector<Command> mCommands;
+		std::vector<EntityPtr> mCreatedEntities;
+		std::vector<std::pair<EntityId, unsigned int>> mOrder;
+		std::vector<unsigned int> mCommandIndices;
+		std::vector<unsigned int> mAddedCommands;
+		std::vector<unsigned int> mReplacedCommands;
+		ComponentIdList mAddedIndices;
+		std::vector<IComponent*> mAddedComponents;
+		ComponentIdList mChangedIndices;
+		std::vector<IComponent*> mChangedComponents;
+		std::map<ComponentId, std::stack<IComponent*>> mComponentPools;
+		std::map<ComponentId, const ComponentTypeInfo*> mComponentTypes;
+};
+
+template <typename T, typename... TArgs>
+void EntityCommandBuffer::Add(const EntityId id, TArgs&&... args)
+{
+	Record(CommandType::Add, id, ComponentTypeId::Get<T>(), StageComponent<T>(std::forward<TArgs>(args)...), &ApplyComponent<T>);
+}
+
+template <typename T>
+void EntityCommandBuffer::Remove(const EntityId id)
+{
+	Record(CommandType::Remove, id, ComponentTypeId::Get<T>(), nullptr, nullptr);
+}
+
+template <typename T, typename... TArgs>
+void EntityCommandBuffer::Replace(const EntityId id, TArgs&&... args)
+{
+	Record(CommandType::Replace, id, ComponentTypeId::Get<T>(), StageComponent<T>(std::forward<TArgs>(args)...), &ApplyComponent<T>);
+}
+
+template <typename T, typename... TArgs>
+auto EntityCommandBuffer::StageComponent(TArgs&&... args) -> IComponent*
+{
+	auto &componentPool = mComponentPools[ComponentTypeId::Get<T>()];
+	IComponent* component = nullptr;
+
+	mComponentTypes[ComponentTypeId::Get<T>()] = ComponentTypeInfo::Get<T>();
+
+	if(componentPool.size() > 0)
+	{
+		component = componentPool.top();
+		componentPool.pop();
+	}
+	else
+	{
+		component = new T();
+	}
+
+	(static_cast<T*>(component))->Reset(std::forward<TArgs>(args)...);
+
+	return component;
+}
+
+template <typename T>
+auto EntityCommandBuffer::ApplyComponent(Entity* entity, IComponent* component) -> IComponent*
+{
+	// The staged data moves into a component of the pool, the staged object is kept for reuse
+	auto target = entity->AcquireComponent<T>();
+	std::swap(*static_cast<T*>(target), *static_cast<T*>(component));
+
+	return target;
+}
+}
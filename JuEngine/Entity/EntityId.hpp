@@ -0,0 +1,68 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../DllExport.hpp"
+#include <cstdint>
+#include <functional>
+
+namespace JuEngine
+{
+// Weak entity handle. The version changes each time the entity is destroyed, so handles to
+// destroyed (or reused) entities are detected by Pool::IsValid. Version 0 is the null handle.
+struct JUENGINEAPI EntityId
+{
+	public:
+		EntityId() = default;
+		EntityId(const std::uint32_t index, const std::uint32_t version) : index(index), version(version) {}
+
+		inline bool IsNull() const;
+		inline auto GetValue() const -> std::uint64_t;
+
+		inline bool operator ==(const EntityId& right) const;
+		inline bool operator !=(const EntityId& right) const;
+		inline bool operator <(const EntityId& right) const;
+
+		std::uint32_t index{0};
+		std::uint32_t version{0};
+};
+
+bool EntityId::IsNull() const
+{
+	return version == 0;
+}
+
+auto EntityId::GetValue() const -> std::uint64_t
+{
+	return (static_cast<std::uint64_t>(version) << 32) | index;
+}
+
+bool EntityId::operator ==(const EntityId& right) const
+{
+	return index == right.index && version == right.version;
+}
+
+bool EntityId::operator !=(const EntityId& right) const
+{
+	return ! (*this == right);
+}
+
+bool EntityId::operator <(const EntityId& right) const
+{
+	return GetValue() < right.GetValue();
+}
+}
+
+namespace std
+{
+template <>
+struct hash<JuEngine::EntityId>
+{
+	std::size_t operator()(const JuEngine::EntityId& id) const
+	{
+		return hash<std::uint64_t>()(id.GetValue());
+	}
+};
+}
@@ -0,0 +1,156 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Pool.hpp"
+#include "Group.hpp"
+#include <tuple>
+
+namespace JuEngine
+{
+namespace EntityViewImpl
+{
+template <unsigned int... Is> struct Indices {};
+template <unsigned int N, unsigned int... Is> struct BuildIndices : BuildIndices<N - 1, N - 1, Is...> {};
+template <unsigned int... Is> struct BuildIndices<0, Is...> { typedef Indices<Is...> type; };
+}
+
+// Typed iteration over every entity that has all the Ts components, the function receives
+// (Entity*, Ts&...). Adding or removing components or entities while iterating is not allowed.
+// Pointer storage pools fall back to iterating the matching group.
+template <typename... Ts>
+class EntityView
+{
+	static_assert(sizeof...(Ts) > 0, "EntityView requires at least one component type");
+
+	public:
+		EntityView(Pool* pool);
+
+		template <typename TFunction> inline void Each(TFunction function);
+
+	private:
+		typedef typename EntityViewImpl::BuildIndices<sizeof...(Ts)>::type IndicesType;
+
+		template <typename TFunction, unsigned int... Is> inline void EachComponentArray(TFunction& function, EntityViewImpl::Indices<Is...>);
+		template <typename TFunction, unsigned int... Is> inline void EachArchetype(TFunction& function, EntityViewImpl::Indices<Is...>);
+		template <typename TFunction> inline void EachGroup(TFunction& function);
+
+		Pool* mPool;
+};
+
+template <typename... Ts>
+EntityView<Ts...>::EntityView(Pool* pool) : mPool(pool)
+{
+}
+
+template <typename... Ts>
+template <typename TFunction>
+void EntityView<Ts...>::Each(TFunction function)
+{
+	switch(mPool->mStorageMode)
+	{
+		case PoolStorageMode::SparseSet:
+			EachComponentArray(function, IndicesType());
+			break;
+		case PoolStorageMode::Archetype:
+			EachArchetype(function, IndicesType());
+			break;
+		default:
+			EachGroup(function);
+			break;
+	}
+}
+
+template <typename... Ts>
+template <typename TFunction, unsigned int... Is>
+void EntityView<Ts...>::EachComponentArray(TFunction& function, EntityViewImpl::Indices<Is...>)
+{
+	auto &componentArrays = mPool->mComponentArrays;
+	IComponentArray* arrays[] = { (ComponentTypeId::Get<Ts>() < componentArrays.size() ? componentArrays[ComponentTypeId::Get<Ts>()] : nullptr)... };
+	IComponentArray* smallest = arrays[0];
+
+	for(auto array : arrays)
+	{
+		if(array == nullptr)
+		{
+			return;
+		}
+
+		if(array->Count() < smallest->Count())
+		{
+			smallest = array;
+		}
+	}
+
+	auto typedArrays = std::tuple<ComponentArray<Ts>*...>(static_cast<ComponentArray<Ts>*>(arrays[Is])...);
+	auto &entityIndices = smallest->GetEntityIndices();
+
+	for(unsigned int i = 0, count = entityIndices.size(); i < count; ++i)
+	{
+		auto entityIndex = entityIndices[i];
+		bool hasAll = true;
+
+		for(auto array : arrays)
+		{
+			if(array != smallest && ! array->Has(entityIndex))
+			{
+				hasAll = false;
+				break;
+			}
+		}
+
+		if(hasAll)
+		{
+			function(mPool->mEntityTable[entityIndex], *std::get<Is>(typedArrays)->Get(entityIndex)...);
+		}
+	}
+}
+
+template <typename... Ts>
+template <typename TFunction, unsigned int... Is>
+void EntityView<Ts...>::EachArchetype(TFunction& function, EntityViewImpl::Indices<Is...>)
+{
+	ComponentMask mask;
+	int expand[] = { (mask.set(ComponentTypeId::Get<Ts>()), 0)... };
+	(void) expand;
+
+	for(auto archetype : mPool->GetArchetypes())
+	{
+		if(archetype->Count() == 0 || (archetype->GetComponentMask() & mask) != mask)
+		{
+			continue;
+		}
+
+		for(unsigned int chunk = 0, chunkCount = archetype->GetChunkCount(); chunk < chunkCount; ++chunk)
+		{
+			auto entities = archetype->GetChunkEntities(chunk);
+			auto columns = std::tuple<Ts*...>(archetype->template GetChunkComponents<Ts>(chunk)...);
+
+			for(unsigned int row = 0, rowCount = archetype->GetChunkRowCount(chunk); row < rowCount; ++row)
+			{
+				function(entities[row], std::get<Is>(columns)[row]...);
+			}
+		}
+	}
+}
+
+template <typename... Ts>
+template <typename TFunction>
+void EntityView<Ts...>::EachGroup(TFunction& function)
+{
+	auto group = mPool->GetGroup(Matcher::AllOf(ComponentIdList({ ComponentTypeId::Get<Ts>()... })));
+
+	for(const auto &entity : group->mEntities)
+	{
+		function(entity.get(), *entity->template Get<Ts>()...);
+	}
+}
+
+template <typename... Ts>
+auto Pool::View() -> EntityView<Ts...>
+{
+	return EntityView<Ts...>(this);
+}
+}
@@ -4,8 +4,11 @@
 
 #include "Group.hpp"
 #include "GroupObserver.hpp"
+#include "EntityCommandBuffer.hpp"
+#include "Pool.hpp"
 #include "../App.hpp"
-#include <algorithm>
+#include "../Services/IJobService.hpp"
+#include <exception>
 
 namespace JuEngine
 {
@@ -13,6 +16,10 @@ Group::Group(const Matcher& matcher) : mMatcher(matcher)
 {
 }
 
+Group::~Group()
+{
+}
+
 auto Group::Count() const -> const unsigned int
 {
 	return mEntities.size();
@@ -20,12 +27,27 @@ auto Group::Count() const -> const unsigned int
 
 auto Group::GetEntities() -> std::vector<EntityPtr>
 {
-	if(mEntitiesCache.empty() && !mEntities.empty())
+	return mEntities;
+}
+
+auto Group::GetEntityList() const -> const std::vector<EntityPtr>&
+{
+	return mEntities;
+}
+
+auto Group::GetEntityIds() -> const std::vector<EntityId>&
+{
+	if(mEntityIdsCache.empty() && !mEntities.empty())
 	{
-		mEntitiesCache = std::vector<EntityPtr>(mEntities.begin(), mEntities.end());
+		mEntityIdsCache.reserve(mEntities.size());
+
+		for(const auto &entity : mEntities)
+		{
+			mEntityIdsCache.push_back(entity->GetId());
+		}
 	}
 
-	return mEntitiesCache;
+	return mEntityIdsCache;
 }
 
 auto Group::GetSingleEntity() const -> EntityPtr
@@ -34,7 +56,7 @@ auto Group::GetSingleEntity() const -> EntityPtr
 
 	if(count == 1)
 	{
-		return *(mEntities.begin());
+		return mEntities.front();
 	}
 	else if(count == 0)
 	{
@@ -42,7 +64,7 @@ auto Group::GetSingleEntity() const -> EntityPtr
 	}
 	else
 	{
-		ThrowRuntimeError("Error, cannot get the single entity from group. Group contains %s entities", mEntities.size());
+		ThrowRuntimeError("Error, cannot get the single entity from group. Group contains %u entities", count);
 	}
 
 	return nullptr;
@@ -50,7 +72,16 @@ auto Group::GetSingleEntity() const -> EntityPtr
 
 bool Group::ContainsEntity(const EntityPtr& entity) const
 {
-	return std::find(mEntities.begin(), mEntities.end(), entity) != mEntities.end();
+	auto position = GetPosition(entity->GetIndex());
+
+	return position != Pool::InvalidPosition && mEntities[position] == entity;
+}
+
+bool Group::ContainsEntity(const EntityId id) const
+{
+	auto position = GetPosition(id.index);
+
+	return position != Pool::InvalidPosition && mEntities[position]->GetId() == id;
 }
 
 auto Group::GetMatcher() const -> Matcher
@@ -58,9 +89,9 @@ auto Group::GetMatcher() const -> Matcher
 	return mMatcher;
 }
 
-auto Group::CreateObserver(const GroupEventType eventType) -> std::shared_ptr<GroupObserver>
+auto Group::CreateObserver(const GroupEventType eventType, const GroupObserverMode mode) -> std::shared_ptr<GroupObserver>
 {
-	return std::shared_ptr<GroupObserver>(new GroupObserver(mInstance.lock(), eventType));
+	return std::shared_ptr<GroupObserver>(new GroupObserver(mInstance.lock(), eventType, mode));
 }
 
 void Group::SetInstance(std::shared_ptr<Group> instance)
@@ -116,13 +147,23 @@ void Group::RemoveAllEventHandlers()
 
 bool Group::AddEntitySilently(EntityPtr entity)
 {
-	if(mEntities.insert(entity).second)
+	auto entityIndex = entity->GetIndex();
+
+	if(GetPosition(entityIndex) != Pool::InvalidPosition)
+	{
+		return false;
+	}
+
+	if(entityIndex >= mEntityPositions.size())
 	{
-		mEntitiesCache.clear();
-		return true;
+		mEntityPositions.resize(entityIndex + 1, Pool::InvalidPosition);
 	}
 
-	return false;
+	mEntityPositions[entityIndex] = mEntities.size();
+	mEntities.push_back(entity);
+	mEntityIdsCache.clear();
+
+	return true;
 }
 
 void Group::AddEntity(EntityPtr entity, ComponentId index, IComponent* component)
@@ -140,13 +181,26 @@ auto Group::AddEntity(EntityPtr entity) -> GroupChanged*
 
 bool Group::RemoveEntitySilently(EntityPtr entity)
 {
-	if(mEntities.erase(entity))
+	auto entityIndex = entity->GetIndex();
+	auto position = GetPosition(entityIndex);
+
+	if(position == Pool::InvalidPosition)
 	{
-		mEntitiesCache.clear();
-		return true;
+		return false;
 	}
 
-	return false;
+	// Swap with the last entity to keep the list packed
+	if(position != mEntities.size() - 1)
+	{
+		mEntities[position] = std::move(mEntities.back());
+		mEntityPositions[mEntities[position]->GetIndex()] = position;
+	}
+
+	mEntities.pop_back();
+	mEntityPositions[entityIndex] = Pool::InvalidPosition;
+	mEntityIdsCache.clear();
+
+	return true;
 }
 
 void Group::RemoveEntity(EntityPtr entity, ComponentId index, IComponent* component)
@@ -161,4 +215,104 @@ auto Group::RemoveEntity(EntityPtr entity) -> GroupChanged*
 {
 	return RemoveEntitySilently(entity) ? &OnEntityRemoved : nullptr;
 }
+
+auto Group::GetPosition(const unsigned int entityIndex) const -> unsigned int
+{
+	if(entityIndex >= mEntityPositions.size())
+	{
+		return Pool::InvalidPosition;
+	}
+
+	return mEntityPositions[entityIndex];
+}
+
+// Each range gets its own command buffer, so the result doesn't depend on how the ranges are scheduled.
+// The buffers are kept in the group (with their staged components) to be reused in the next iteration.
+void Group::ParallelForRanges(const std::function<void(const unsigned int begin, const unsigned int end, EntityCommandBuffer& commandBuffer)>& function, const unsigned int grainSize)
+{
+	const unsigned int count = mEntities.size();
+	const unsigned int grain = (grainSize > 0 ? grainSize : Archetype::ChunkSize / sizeof(EntityPtr));
+	const unsigned int rangeCount = (count + grain - 1) / grain;
+	auto jobs = App::Jobs();
+	std::exception_ptr exception;
+	std::mutex exceptionMutex;
+
+	if(mPool == nullptr)
+	{
+		ThrowRuntimeError("Error, cannot iterate group in parallel, the group was not created by a pool.");
+	}
+
+	if(mIteratingInParallel)
+	{
+		ThrowRuntimeError("Error, cannot iterate group in parallel, the group is already being iterated in parallel.");
+	}
+
+	while(mCommandBuffers.size() < rangeCount)
+	{
+		mCommandBuffers.push_back(std::unique_ptr<EntityCommandBuffer>(new EntityCommandBuffer(mPool)));
+	}
+
+	auto runRanges = [&](const unsigned int firstRange, const unsigned int lastRange)
+	{
+		for(unsigned int range = firstRange; range < lastRange; ++range)
+		{
+			try
+			{
+				function(range * grain, std::min((range + 1) * grain, count), *mCommandBuffers[range]);
+			}
+			catch(...)
+			{
+				std::lock_guard<std::mutex> lock(exceptionMutex);
+				exception = (exception != nullptr ? exception : std::current_exception());
+			}
+		}
+	};
+
+	mIteratingInParallel = true;
+	++mPool->mLockCount;
+
+	try
+	{
+		if(jobs != nullptr)
+		{
+			jobs->ParallelFor(rangeCount, 1, runRanges);
+		}
+		else
+		{
+			runRanges(0, rangeCount);
+		}
+	}
+	catch(...)
+	{
+		exception = (exception != nullptr ? exception : std::current_exception());
+	}
+
+	--mPool->mLockCount;
+
+	try
+	{
+		if(exception != nullptr)
+		{
+			std::rethrow_exception(exception);
+		}
+
+		for(unsigned int range = 0; range < rangeCount; ++range)
+		{
+			mCommandBuffers[range]->Playback();
+		}
+	}
+	catch(...)
+	{
+		// The changes of a failed iteration are dropped
+		for(unsigned int range = 0; range < rangeCount; ++range)
+		{
+			mCommandBuffers[range]->Clear();
+		}
+
+		mIteratingInParallel = false;
+		throw;
+	}
+
+	mIteratingInParallel = false;
+}
 }
@@ -7,27 +7,38 @@
 #include "Entity.hpp"
 #include "Matcher.hpp"
 #include "GroupEventType.hpp"
-#include <unordered_set>
+#include <functional>
+#include <vector>
 
 namespace JuEngine
 {
 class GroupObserver;
+class EntityCommandBuffer;
 
 class JUENGINEAPI Group
 {
 	friend class Pool;
+	template <typename... Ts> friend class EntityView;
 
 	public:
 		Group(const Matcher& matcher);
+		~Group();
 		auto Count() const -> const unsigned int;
 		auto GetEntities() -> std::vector<EntityPtr>;
+		// The list is reordered when entities leave the group, don't keep it while the group changes
+		auto GetEntityList() const -> const std::vector<EntityPtr>&;
+		auto GetEntityIds() -> const std::vector<EntityId>&;
 		auto GetSingleEntity() const -> EntityPtr;
 		bool ContainsEntity(const EntityPtr& entity) const;
+		bool ContainsEntity(const EntityId id) const;
 		auto GetMatcher() const -> Matcher;
-		auto CreateObserver(const GroupEventType eventType) -> std::shared_ptr<GroupObserver>;
+		auto CreateObserver(const GroupEventType eventType, const GroupObserverMode mode = GroupObserverMode::Entities) -> std::shared_ptr<GroupObserver>;
+		// The function receives each entity and a command buffer (the pool rejects the structural changes
+		// while iterating), the buffers are played back in the entity order when the iteration ends
+		template <typename TFunction> inline void ParallelForEach(TFunction function, const unsigned int grainSize = 0);
 
-		using GroupChanged = Delegate<void(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)>;
-		using GroupUpdated = Delegate<void(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)>;
+		using GroupChanged = Delegate<void(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component), DelegateNoLock>;
+		using GroupUpdated = Delegate<void(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent), DelegateNoLock>;
 
 		GroupChanged OnEntityAdded;
 		GroupUpdated OnEntityUpdated;
@@ -48,10 +59,28 @@ class JUENGINEAPI Group
 		bool RemoveEntitySilently(EntityPtr entity);
 		void RemoveEntity(EntityPtr entity, ComponentId index, IComponent* component);
 		auto RemoveEntity(EntityPtr entity) -> GroupChanged*;
+		auto GetPosition(const unsigned int entityIndex) const -> unsigned int;
+		void ParallelForRanges(const std::function<void(const unsigned int begin, const unsigned int end, EntityCommandBuffer& commandBuffer)>& function, const unsigned int grainSize);
 
 		std::weak_ptr<Group> mInstance;
+		Pool* mPool{nullptr};
 		Matcher mMatcher;
-		std::unordered_set<EntityPtr> mEntities;
-		std::vector<EntityPtr> mEntitiesCache;
+		std::vector<EntityPtr> mEntities;
+		std::vector<unsigned int> mEntityPositions;
+		std::vector<EntityId> mEntityIdsCache;
+		std::vector<std::unique_ptr<EntityCommandBuffer>> mCommandBuffers;
+		bool mIteratingInParallel{false};
 };
+
+template <typename TFunction>
+void Group::ParallelForEach(TFunction function, const unsigned int grainSize)
+{
+	ParallelForRanges([this, &function](const unsigned int begin, const unsigned int end, EntityCommandBuffer& commandBuffer)
+	{
+		for(unsigned int i = begin; i < end; ++i)
+		{
+			function(mEntities[i], commandBuffer);
+		}
+	}, grainSize);
+}
 }
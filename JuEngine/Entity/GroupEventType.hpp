@@ -4,6 +4,9 @@
 
 #pragma once
 
+#include "../DllExport.hpp"
+#include "Entity.hpp"
+
 namespace JuEngine
 {
 enum class GroupEventType
@@ -12,4 +15,19 @@ enum class GroupEventType
 	OnEntityRemoved,
 	OnEntityAddedOrRemoved
 };
+
+enum class GroupObserverMode
+{
+	Entities,
+	EntityIds,
+	Events
+};
+
+// The entity and the last group change (OnEntityAdded or OnEntityRemoved) collected for it
+struct JUENGINEAPI GroupEvent
+{
+	EntityPtr entity;
+	GroupEventType eventType;
+	ComponentId index;
+};
 }
@@ -0,0 +1,35 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "GroupHandle.hpp"
+#include "Group.hpp"
+#include "../App.hpp"
+
+namespace JuEngine
+{
+GroupHandle::GroupHandle(Pool* pool, const Matcher& matcher) : mPool(pool), mMatcher(matcher)
+{
+}
+
+auto GroupHandle::GetPool() const -> Pool*
+{
+	return mPool;
+}
+
+auto GroupHandle::GetMatcher() const -> const Matcher&
+{
+	return mMatcher;
+}
+
+void GroupHandle::Resolve()
+{
+	if(mPool == nullptr)
+	{
+		ThrowRuntimeError("Error, the group handle has no pool.");
+	}
+
+	mGroup = mPool->GetGroup(mMatcher);
+	mGroupsVersion = mPool->mGroupsVersion;
+}
+}
@@ -0,0 +1,47 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Pool.hpp"
+
+namespace JuEngine
+{
+// Resolves the group of a matcher once and keeps it, so systems don't build and hash a matcher
+// every frame. The group is resolved again if the groups of the pool were cleared.
+class JUENGINEAPI GroupHandle
+{
+	public:
+		GroupHandle() = default;
+		GroupHandle(Pool* pool, const Matcher& matcher);
+
+		inline auto Get() -> Group*;
+		inline auto operator ->() -> Group*;
+		auto GetPool() const -> Pool*;
+		auto GetMatcher() const -> const Matcher&;
+
+	private:
+		void Resolve();
+
+		Pool* mPool{nullptr};
+		Matcher mMatcher;
+		std::shared_ptr<Group> mGroup;
+		unsigned int mGroupsVersion{0};
+};
+
+auto GroupHandle::Get() -> Group*
+{
+	if(mGroup == nullptr || mGroupsVersion != mPool->mGroupsVersion)
+	{
+		Resolve();
+	}
+
+	return mGroup.get();
+}
+
+auto GroupHandle::operator ->() -> Group*
+{
+	return Get();
+}
+}
@@ -8,18 +8,22 @@
 
 namespace JuEngine
 {
-GroupObserver::GroupObserver(std::shared_ptr<Group> group, const GroupEventType eventType)
+GroupObserver::GroupObserver(std::shared_ptr<Group> group, const GroupEventType eventType, const GroupObserverMode mode)
 {
+	mMode = mode;
 	mGroups.push_back(group);
 	mEventTypes.push_back(eventType);
-	mAddEntityCache = std::bind(&GroupObserver::AddEntity, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+	mAddedHandles.resize(mGroups.size(), 0);
+	mRemovedHandles.resize(mGroups.size(), 0);
 }
 
-GroupObserver::GroupObserver(std::vector<std::shared_ptr<Group>> groups, std::vector<GroupEventType> eventTypes)
+GroupObserver::GroupObserver(std::vector<std::shared_ptr<Group>> groups, std::vector<GroupEventType> eventTypes, const GroupObserverMode mode)
 {
+	mMode = mode;
 	mGroups = groups;
 	mEventTypes = eventTypes;
-	mAddEntityCache = std::bind(&GroupObserver::AddEntity, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
+	mAddedHandles.resize(mGroups.size(), 0);
+	mRemovedHandles.resize(mGroups.size(), 0);
 
 	if(groups.size() != eventTypes.size())
 	{
@@ -36,55 +40,165 @@ GroupObserver::~GroupObserver()
 
 void GroupObserver::Activate()
 {
+	Disconnect();
+
+	auto addedEntity = [this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		AddEntity(entity, GroupEventType::OnEntityAdded, index);
+	};
+
+	auto removedEntity = [this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		AddEntity(entity, GroupEventType::OnEntityRemoved, index);
+	};
+
 	for(unsigned int i = 0, groupCount = mGroups.size(); i < groupCount; ++i)
 	{
 		auto g = mGroups[i];
 		auto eventType = mEventTypes[i];
 
-		if(eventType == GroupEventType::OnEntityAdded)
+		if(eventType == GroupEventType::OnEntityAdded || eventType == GroupEventType::OnEntityAddedOrRemoved)
 		{
-			g->OnEntityAdded -= mAddEntityCache;
-			g->OnEntityAdded += mAddEntityCache;
+			mAddedHandles[i] = g->OnEntityAdded.Subscribe(addedEntity);
 		}
-		else if(eventType == GroupEventType::OnEntityRemoved)
-		{
-			g->OnEntityRemoved -= mAddEntityCache;
-			g->OnEntityRemoved += mAddEntityCache;
-		}
-		else if(eventType == GroupEventType::OnEntityAddedOrRemoved)
-		{
-			g->OnEntityAdded -= mAddEntityCache;
-			g->OnEntityAdded += mAddEntityCache;
 
-			g->OnEntityRemoved -= mAddEntityCache;
-			g->OnEntityRemoved += mAddEntityCache;
+		if(eventType == GroupEventType::OnEntityRemoved || eventType == GroupEventType::OnEntityAddedOrRemoved)
+		{
+			mRemovedHandles[i] = g->OnEntityRemoved.Subscribe(removedEntity);
 		}
 	}
 }
 
 void GroupObserver::Deactivate()
 {
-	for(const auto &g : mGroups)
-	{
-		g->OnEntityAdded -= mAddEntityCache;
-		g->OnEntityRemoved -= mAddEntityCache;
-	}
-
+	Disconnect();
 	ClearCollectedEntities();
 }
 
-auto GroupObserver::GetCollectedEntities() -> std::unordered_set<EntityPtr>
+auto GroupObserver::GetCollectedEntities() const -> const std::vector<EntityPtr>&
 {
 	return mCollectedEntities;
 }
 
+auto GroupObserver::GetCollectedEntityIds() const -> const std::vector<EntityId>&
+{
+	return mCollectedEntityIds;
+}
+
+auto GroupObserver::GetCollectedEvents() const -> const std::vector<GroupEvent>&
+{
+	return mCollectedEvents;
+}
+
+void GroupObserver::SwapCollectedEntities(std::vector<EntityPtr>& entities)
+{
+	ResetCollectedPositions();
+	entities.clear();
+	mCollectedEntities.swap(entities);
+}
+
+void GroupObserver::SwapCollectedEntityIds(std::vector<EntityId>& ids)
+{
+	ResetCollectedPositions();
+	ids.clear();
+	mCollectedEntityIds.swap(ids);
+}
+
+void GroupObserver::SwapCollectedEvents(std::vector<GroupEvent>& events)
+{
+	ResetCollectedPositions();
+	events.clear();
+	mCollectedEvents.swap(events);
+}
+
 void GroupObserver::ClearCollectedEntities()
 {
+	ResetCollectedPositions();
 	mCollectedEntities.clear();
+	mCollectedEntityIds.clear();
+	mCollectedEvents.clear();
+}
+
+void GroupObserver::Disconnect()
+{
+	for(unsigned int i = 0, groupCount = mGroups.size(); i < groupCount; ++i)
+	{
+		if(mAddedHandles[i] != 0)
+		{
+			mGroups[i]->OnEntityAdded.Unsubscribe(mAddedHandles[i]);
+			mAddedHandles[i] = 0;
+		}
+
+		if(mRemovedHandles[i] != 0)
+		{
+			mGroups[i]->OnEntityRemoved.Unsubscribe(mRemovedHandles[i]);
+			mRemovedHandles[i] = 0;
+		}
+	}
 }
 
-void GroupObserver::AddEntity(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+// Only the positions of the collected entities are reset, not the whole table
+void GroupObserver::ResetCollectedPositions()
 {
-	mCollectedEntities.insert(entity);
+	for(const auto &entity : mCollectedEntities)
+	{
+		mCollectedPositions[entity->GetIndex()] = 0;
+	}
+
+	for(const auto &id : mCollectedEntityIds)
+	{
+		mCollectedPositions[id.index] = 0;
+	}
+
+	for(const auto &event : mCollectedEvents)
+	{
+		mCollectedPositions[event.entity->GetIndex()] = 0;
+	}
+}
+
+void GroupObserver::AddEntity(const EntityPtr& entity, const GroupEventType eventType, const ComponentId index)
+{
+	auto entityIndex = entity->GetIndex();
+
+	if(entityIndex >= mCollectedPositions.size())
+	{
+		mCollectedPositions.resize(entityIndex + 1, 0);
+	}
+
+	// Positions are stored plus one, zero means not collected
+	auto &position = mCollectedPositions[entityIndex];
+
+	if(mMode == GroupObserverMode::EntityIds)
+	{
+		// Entity handles don't retain the entity, destroyed entities are detected later by its version
+		if(position == 0)
+		{
+			mCollectedEntityIds.push_back(entity->GetId());
+			position = mCollectedEntityIds.size();
+		}
+		else
+		{
+			// The index was reused by a new entity, the collected one has been destroyed
+			mCollectedEntityIds[position - 1] = entity->GetId();
+		}
+	}
+	else if(mMode == GroupObserverMode::Events)
+	{
+		if(position == 0 || mCollectedEvents[position - 1].entity != entity)
+		{
+			mCollectedEvents.push_back({ entity, eventType, index });
+			position = mCollectedEvents.size();
+		}
+		else
+		{
+			mCollectedEvents[position - 1].eventType = eventType;
+			mCollectedEvents[position - 1].index = index;
+		}
+	}
+	else if(position == 0 || mCollectedEntities[position - 1] != entity)
+	{
+		mCollectedEntities.push_back(entity);
+		position = mCollectedEntities.size();
+	}
 }
 }
@@ -8,31 +8,47 @@
 #include "Entity.hpp"
 #include "GroupEventType.hpp"
 #include <vector>
-#include <unordered_set>
 #include <functional>
 
 namespace JuEngine
 {
 class Group;
 
+// The entities are collected once each (in collection order) into a dense buffer, which the
+// observer swaps with the one of the caller instead of copying it. The groups must belong to
+// the same pool (the entities are deduplicated by their index). In the Events mode an entity
+// keeps the position of its first event but the event and component index of the last one.
 class JUENGINEAPI GroupObserver
 {
 	public:
-		GroupObserver(std::shared_ptr<Group> group, const GroupEventType eventType);
-		GroupObserver(std::vector<std::shared_ptr<Group>> groups, std::vector<GroupEventType> eventTypes);
+		GroupObserver(std::shared_ptr<Group> group, const GroupEventType eventType, const GroupObserverMode mode = GroupObserverMode::Entities);
+		GroupObserver(std::vector<std::shared_ptr<Group>> groups, std::vector<GroupEventType> eventTypes, const GroupObserverMode mode = GroupObserverMode::Entities);
 		~GroupObserver();
 
 		void Activate();
 		void Deactivate();
-		auto GetCollectedEntities() -> std::unordered_set<EntityPtr>;
+		auto GetCollectedEntities() const -> const std::vector<EntityPtr>&;
+		auto GetCollectedEntityIds() const -> const std::vector<EntityId>&;
+		auto GetCollectedEvents() const -> const std::vector<GroupEvent>&;
+		// The previous content of the given buffer is discarded
+		void SwapCollectedEntities(std::vector<EntityPtr>& entities);
+		void SwapCollectedEntityIds(std::vector<EntityId>& ids);
+		void SwapCollectedEvents(std::vector<GroupEvent>& events);
 		void ClearCollectedEntities();
 
 	private:
-		void AddEntity(std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component);
+		void AddEntity(const EntityPtr& entity, const GroupEventType eventType, const ComponentId index);
+		void Disconnect();
+		void ResetCollectedPositions();
 
-		std::unordered_set<EntityPtr> mCollectedEntities;
+		std::vector<EntityPtr> mCollectedEntities;
+		std::vector<EntityId> mCollectedEntityIds;
+		std::vector<GroupEvent> mCollectedEvents;
+		std::vector<unsigned int> mCollectedPositions;
+		GroupObserverMode mMode{GroupObserverMode::Entities};
 		std::vector<std::shared_ptr<Group>> mGroups;
 		std::vector<GroupEventType> mEventTypes;
-		std::function<void(std::shared_ptr<Group>, EntityPtr, ComponentId, IComponent*)> mAddEntityCache;
+		std::vector<DelegateHandle> mAddedHandles;
+		std::vector<DelegateHandle> mRemovedHandles;
 };
 }
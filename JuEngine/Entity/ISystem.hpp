@@ -7,10 +7,12 @@
 #include "Entity.hpp"
 #include "Matcher.hpp"
 #include "TriggerOnEvent.hpp"
+#include "../Resources/Span.hpp"
 
 namespace JuEngine
 {
 class Pool;
+typedef Span<const EntityPtr> EntitySpan;
 
 class JUENGINEAPI ISystem
 {
@@ -73,7 +75,13 @@ class JUENGINEAPI IReactiveExecuteSystem : public ISystem
 	public:
 		virtual ~IReactiveExecuteSystem() = default;
 
-		virtual void Execute(std::vector<EntityPtr> entities) = 0;
+		// The span is only valid during the call (the buffer is reused in the next execution). The
+		// systems implementing IEntityIdReactiveSystem or IGroupEventReactiveSystem don't override it.
+		virtual void Execute(EntitySpan entities) {}
+
+	private:
+		// The systems still overriding the old signature fail to compile instead of never being called
+		virtual void Execute(std::vector<EntityPtr> entities) final {}
 };
 
 class JUENGINEAPI IReactiveSystem : public IReactiveExecuteSystem
@@ -115,4 +123,53 @@ class JUENGINEAPI IClearReactiveSystem
 	protected:
 		IClearReactiveSystem() = default;
 };
+
+// Reactive systems implementing this interface receive entity handles instead of entity pointers
+// (ExecuteIds is called instead of Execute), the entities destroyed since collected are skipped
+class JUENGINEAPI IEntityIdReactiveSystem
+{
+	protected:
+		IEntityIdReactiveSystem() = default;
+
+	public:
+		virtual ~IEntityIdReactiveSystem() = default;
+
+		virtual void ExecuteIds(const std::vector<EntityId>& entities) = 0;
+};
+
+// Reactive systems implementing this interface receive each collected entity once with the last group
+// event it triggered (ExecuteEvents is called instead of Execute), in the order of their first event
+class JUENGINEAPI IGroupEventReactiveSystem
+{
+	protected:
+		IGroupEventReactiveSystem() = default;
+
+	public:
+		virtual ~IGroupEventReactiveSystem() = default;
+
+		virtual void ExecuteEvents(Span<const GroupEvent> events) = 0;
+};
+
+// Execute systems declaring the component types they read and write can run concurrently with
+// the systems of the same container they don't conflict with. These systems must be created with
+// Pool::CreateSystem. While they run concurrently they must not add, remove or replace components
+// nor create groups (record the changes in an EntityCommandBuffer owned by the system instead), the
+// pool rejects them.
+class JUENGINEAPI IComponentAccess
+{
+	friend class Pool;
+	friend class SystemContainer;
+
+	protected:
+		IComponentAccess() = default;
+
+	public:
+		virtual ~IComponentAccess() = default;
+
+		Matcher readComponents;
+		Matcher writeComponents;
+
+	private:
+		Pool* mPool{nullptr};
+};
 }
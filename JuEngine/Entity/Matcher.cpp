@@ -12,7 +12,9 @@ auto Matcher::AllOf(const ComponentIdList indices) -> const Matcher
 {
 	auto matcher = Matcher();
 	matcher.mAllOfIndices = DistinctIndices(indices);
+	matcher.CalculateIndices();
 	matcher.CalculateHash();
+	matcher.CalculateMasks();
 
 	return matcher;
 }
@@ -26,7 +28,9 @@ auto Matcher::AnyOf(const ComponentIdList indices) -> const Matcher
 {
 	auto matcher = Matcher();
 	matcher.mAnyOfIndices = DistinctIndices(indices);
+	matcher.CalculateIndices();
 	matcher.CalculateHash();
+	matcher.CalculateMasks();
 
 	return matcher;
 }
@@ -40,7 +44,9 @@ auto Matcher::NoneOf(const ComponentIdList indices) -> const Matcher
 {
 	auto matcher = Matcher();
 	matcher.mNoneOfIndices = DistinctIndices(indices);
+	matcher.CalculateIndices();
 	matcher.CalculateHash();
+	matcher.CalculateMasks();
 
 	return matcher;
 }
@@ -50,41 +56,54 @@ auto Matcher::NoneOf(const MatcherList matchers) -> const Matcher
 	return Matcher::NoneOf(MergeIndices(matchers));
 }
 
+auto Matcher::Create(const ComponentIdList allOfIndices, const ComponentIdList anyOfIndices, const ComponentIdList noneOfIndices) -> const Matcher
+{
+	auto matcher = Matcher();
+	matcher.mAllOfIndices = DistinctIndices(allOfIndices);
+	matcher.mAnyOfIndices = DistinctIndices(anyOfIndices);
+	matcher.mNoneOfIndices = DistinctIndices(noneOfIndices);
+	matcher.CalculateIndices();
+	matcher.CalculateHash();
+	matcher.CalculateMasks();
+
+	return matcher;
+}
+
 bool Matcher::IsEmpty() const
 {
 	return (mAllOfIndices.empty() && mAnyOfIndices.empty() && mNoneOfIndices.empty());
 }
 
-bool Matcher::Matches(const EntityPtr& entity)
+bool Matcher::Matches(const EntityPtr& entity) const
 {
-	auto matchesAllOf = mAllOfIndices.empty() || entity->HasComponents(mAllOfIndices);
-	auto matchesAnyOf = mAnyOfIndices.empty() || entity->HasAnyComponent(mAnyOfIndices);
-	auto matchesNoneOf = mNoneOfIndices.empty() || ! entity->HasAnyComponent(mNoneOfIndices);
+	return Matches(entity->GetComponentMask());
+}
+
+bool Matcher::Matches(const ComponentMask& mask) const
+{
+	auto matchesAllOf = (mask & mAllOfMask) == mAllOfMask;
+	auto matchesAnyOf = mAnyOfMask.none() || (mask & mAnyOfMask).any();
+	auto matchesNoneOf = (mask & mNoneOfMask).none();
 
 	return matchesAllOf && matchesAnyOf && matchesNoneOf;
 }
 
-auto Matcher::GetIndices() -> const ComponentIdList
+auto Matcher::GetIndices() const -> const ComponentIdList&
 {
-	if(mIndices.empty())
-	{
-		mIndices = MergeIndices();
-	}
-
 	return mIndices;
 }
 
-auto Matcher::GetAllOfIndices() const -> const ComponentIdList
+auto Matcher::GetAllOfIndices() const -> const ComponentIdList&
 {
 	return mAllOfIndices;
 }
 
-auto Matcher::GetAnyOfIndices() const -> const ComponentIdList
+auto Matcher::GetAnyOfIndices() const -> const ComponentIdList&
 {
 	return mAnyOfIndices;
 }
 
-auto Matcher::GetNoneOfIndices() const -> const ComponentIdList
+auto Matcher::GetNoneOfIndices() const -> const ComponentIdList&
 {
 	return mNoneOfIndices;
 }
@@ -101,23 +120,7 @@ bool Matcher::CompareIndices(const Matcher& matcher) const
 		return false;
 	}
 
-	auto leftIndices = this->MergeIndices();
-	auto rightIndices = matcher.MergeIndices();
-
-	if(leftIndices.size() != rightIndices.size())
-	{
-		return false;
-	}
-
-	for(unsigned int i = 0, count = leftIndices.size(); i < count; ++i)
-	{
-		if(leftIndices[i] != rightIndices[i])
-		{
-			return false;
-		}
-	}
-
-	return true;
+	return mIndices == matcher.mIndices;
 }
 
 auto Matcher::OnEntityAdded() -> const TriggerOnEvent
@@ -135,9 +138,11 @@ auto Matcher::OnEntityAddedOrRemoved() -> const TriggerOnEvent
 	return TriggerOnEvent(*this, GroupEventType::OnEntityAddedOrRemoved);
 }
 
-bool Matcher::operator ==(const Matcher right) const
+// The index lists are sorted when the matcher is created, they can be compared directly
+bool Matcher::operator ==(const Matcher& right) const
 {
-	return this->GetHashCode() == right.GetHashCode() && this->CompareIndices(right);
+	return mCachedHash == right.mCachedHash && mAllOfIndices == right.mAllOfIndices &&
+		mAnyOfIndices == right.mAnyOfIndices && mNoneOfIndices == right.mNoneOfIndices;
 }
 
 auto Matcher::MergeIndices() const -> ComponentIdList
@@ -163,6 +168,11 @@ auto Matcher::MergeIndices() const -> ComponentIdList
 	return DistinctIndices(indicesList);
 }
 
+void Matcher::CalculateIndices()
+{
+	mIndices = MergeIndices();
+}
+
 void Matcher::CalculateHash()
 {
 	unsigned int hash = typeid(Matcher).hash_code();
@@ -174,6 +184,13 @@ void Matcher::CalculateHash()
 	mCachedHash = hash;
 }
 
+void Matcher::CalculateMasks()
+{
+	mAllOfMask = ComponentTypeId::GetMask(mAllOfIndices);
+	mAnyOfMask = ComponentTypeId::GetMask(mAnyOfIndices);
+	mNoneOfMask = ComponentTypeId::GetMask(mNoneOfIndices);
+}
+
 auto Matcher::ApplyHash(unsigned int hash, const ComponentIdList indices, int i1, int i2) const -> unsigned int
 {
 	if (indices.size() > 0)
@@ -22,13 +22,15 @@ class JUENGINEAPI Matcher
 		static auto AnyOf(const MatcherList matchers) -> const Matcher;
 		static auto NoneOf(const ComponentIdList indices) -> const Matcher;
 		static auto NoneOf(const MatcherList matchers) -> const Matcher;
+		static auto Create(const ComponentIdList allOfIndices, const ComponentIdList anyOfIndices, const ComponentIdList noneOfIndices) -> const Matcher;
 
 		bool IsEmpty() const;
-		bool Matches(const EntityPtr& entity);
-		auto GetIndices() -> const ComponentIdList;
-		auto GetAllOfIndices() const -> const ComponentIdList;
-		auto GetAnyOfIndices() const -> const ComponentIdList;
-		auto GetNoneOfIndices() const -> const ComponentIdList;
+		bool Matches(const EntityPtr& entity) const;
+		bool Matches(const ComponentMask& mask) const;
+		auto GetIndices() const -> const ComponentIdList&;
+		auto GetAllOfIndices() const -> const ComponentIdList&;
+		auto GetAnyOfIndices() const -> const ComponentIdList&;
+		auto GetNoneOfIndices() const -> const ComponentIdList&;
 
 		auto GetHashCode() const -> unsigned int;
 		bool CompareIndices(const Matcher& matcher) const;
@@ -37,15 +39,20 @@ class JUENGINEAPI Matcher
 		auto OnEntityRemoved() -> const TriggerOnEvent;
 		auto OnEntityAddedOrRemoved() -> const TriggerOnEvent;
 
-		bool operator ==(const Matcher right) const;
+		bool operator ==(const Matcher& right) const;
 
 	protected:
+		void CalculateIndices();
 		void CalculateHash();
+		void CalculateMasks();
 
 		ComponentIdList mIndices;
 		ComponentIdList mAllOfIndices;
 		ComponentIdList mAnyOfIndices;
 		ComponentIdList mNoneOfIndices;
+		ComponentMask mAllOfMask;
+		ComponentMask mAnyOfMask;
+		ComponentMask mNoneOfMask;
 
 	private:
 		auto ApplyHash(unsigned int hash, const ComponentIdList indices, int i1, int i2) const -> unsigned int;
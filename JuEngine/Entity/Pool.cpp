@@ -12,18 +12,23 @@
 
 namespace JuEngine
 {
-Pool::Pool(const unsigned int startCreationIndex)
+const unsigned int Pool::InvalidPosition;
+
+Pool::Pool(const unsigned int startCreationIndex, const PoolStorageMode storageMode)
 {
 	mCreationIndex = startCreationIndex;
-	mOnEntityReleasedCache = std::bind(&Pool::OnEntityReleased, this, std::placeholders::_1);
+	mStorageMode = storageMode;
+
+	if(mStorageMode == PoolStorageMode::Archetype)
+	{
+		mArchetypeStorage = new ArchetypeStorage();
+	}
 }
 
 Pool::~Pool()
 {
 	Reset();
 
-	// TODO: Components don't get destroyed.
-
 	if(! mRetainedEntities.empty())
 	{
 		App::Log()->Warning("Warning, some entities remain undestroyed in the pool destruction !");
@@ -35,107 +40,254 @@ Pool::~Pool()
 		mReusableEntities.pop();
 	}
 
-	for(auto &pair : mComponentPools)
+	for(auto &componentAllocator : mComponentAllocators)
 	{
-		auto componentPool = pair.second;
+		delete componentAllocator;
+	}
 
-		while(! componentPool.empty())
-		{
-			delete componentPool.top();
-			componentPool.pop();
-		}
+	if(mArchetypeStorage != nullptr)
+	{
+		delete mArchetypeStorage;
+	}
+
+	for(auto &componentArray : mComponentArrays)
+	{
+		delete componentArray;
 	}
 }
 
 auto Pool::CreateEntity() -> EntityPtr
 {
+	if(mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot create entity, the pool is being iterated in parallel. Use the command buffer instead.");
+	}
+
 	EntityPtr entity;
 
+	// Entities are never deleted while the pool is alive, released entities return to the pool
+	auto releaser = [](Entity* entity)
+	{
+		entity->mPool->OnEntityReleased(entity);
+		entity->OnEntityReleased(entity);
+	};
+
 	if(mReusableEntities.size() > 0)
 	{
-		entity = EntityPtr(mReusableEntities.top());
+		entity = EntityPtr(mReusableEntities.top(), releaser);
 		mReusableEntities.pop();
 	}
 	else
 	{
-		entity = EntityPtr(new Entity(&mComponentPools), [](void* entity)
-		{
-			(static_cast<Entity*>(entity)->OnEntityReleased(static_cast<Entity*>(entity)));
-		});
+		auto componentArrays = (mStorageMode == PoolStorageMode::SparseSet ? &mComponentArrays : nullptr);
+
+		entity = EntityPtr(new Entity(this, &mComponentPools, mArchetypeStorage, componentArrays), releaser);
+		entity->mIndex = mEntityTable.size();
+		mEntityTable.push_back(entity.get());
 	}
 
 	entity->SetInstance(entity);
 	entity->mIsEnabled = true;
 	entity->mUuid = mCreationIndex++;
 
-	mEntities.insert(entity);
-	mEntitiesCache.clear();
-
-	entity->OnComponentAdded += [this](EntityPtr entity, ComponentId index, IComponent* component)
-	{
-		UpdateGroupsComponentAddedOrRemoved(entity, index, component);
-	};
-	entity->OnComponentRemoved += [this](EntityPtr entity, ComponentId index, IComponent* component)
+	if(mArchetypeStorage != nullptr)
 	{
-		UpdateGroupsComponentAddedOrRemoved(entity, index, component);
-	};
-	entity->OnComponentReplaced += [this](EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)
+		entity->mArchetype = mArchetypeStorage->GetRootArchetype();
+		entity->mRow = entity->mArchetype->AddRow(entity.get());
+	}
+
+	if(entity->mIndex >= mEntityPositions.size())
 	{
-		UpdateGroupsComponentReplaced(entity, index, previousComponent, newComponent);
-	};
+		mEntityPositions.resize(entity->mIndex + 1, InvalidPosition);
+	}
+
+	mEntityPositions[entity->mIndex] = mEntities.size();
+	mEntities.push_back(entity);
 
 	entity->OnEntityReleased.Clear();
-	entity->OnEntityReleased += mOnEntityReleasedCache;
 
 	OnEntityCreated(this, entity);
 
 	return entity;
 }
 
+auto Pool::CreateEntities(const unsigned int count, const EntityPtr& prototype) -> std::vector<EntityPtr>
+{
+	auto entities = std::vector<EntityPtr>();
+	auto newEntitiesCount = (count > mReusableEntities.size() ? count - mReusableEntities.size() : 0);
+
+	entities.reserve(count);
+	mEntities.reserve(mEntities.size() + count);
+	mEntityTable.reserve(mEntityTable.size() + newEntitiesCount);
+	mEntityPositions.reserve(mEntityTable.size() + newEntitiesCount);
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		entities.push_back(CreateEntity());
+	}
+
+	if(count == 0 || prototype == nullptr || prototype->GetComponentsCount() == 0)
+	{
+		return entities;
+	}
+
+	auto indices = ComponentIdList();
+	const auto &mask = prototype->GetComponentMask();
+
+	for(ComponentId index = 0; index < mask.size(); ++index)
+	{
+		if(mask[index])
+		{
+			indices.push_back(index);
+			RegisterComponentType(index, prototype->GetComponentType(index));
+		}
+	}
+
+	auto components = std::vector<IComponent*>(indices.size());
+
+	for(const auto &entity : entities)
+	{
+		// The prototype components are read every time, adding components can move them in memory
+		for(unsigned int i = 0, indicesCount = indices.size(); i < indicesCount; ++i)
+		{
+			components[i] = entity->GetPooledComponent(indices[i]);
+			mComponentTypes[indices[i]]->copy(components[i], prototype->GetComponent(indices[i]));
+		}
+
+		entity->InsertComponents(indices, components.data());
+	}
+
+	// Each affected group handles every entity once instead of once per component
+	auto groups = std::vector<std::pair<std::shared_ptr<Group>, unsigned int>>();
+	GetGroupsForIndices(indices, groups);
+
+	for(const auto &pair : groups)
+	{
+		// Every entity ends with the same components, so the reported ones are the same for all
+		const auto &entityMask = entities.front()->GetComponentMask();
+		auto addedIndex = indices[GetGroupEventPosition(pair.first->GetMatcher(), entityMask, indices, true, pair.second)];
+		auto removedIndex = indices[GetGroupEventPosition(pair.first->GetMatcher(), entityMask, indices, false, pair.second)];
+
+		for(const auto &entity : entities)
+		{
+			auto event = pair.first->HandleEntity(entity);
+
+			if(event != nullptr)
+			{
+				auto index = (event == &pair.first->OnEntityAdded ? addedIndex : removedIndex);
+				(*event)(pair.first, entity, index, entity->GetComponent(index));
+			}
+		}
+	}
+
+	for(const auto &entity : entities)
+	{
+		for(const auto &index : indices)
+		{
+			entity->OnComponentAdded(entity, index, entity->GetComponent(index));
+		}
+	}
+
+	return entities;
+}
+
 bool Pool::HasEntity(const EntityPtr& entity) const
 {
-	return std::find(mEntities.begin(), mEntities.end(), std::weak_ptr<Entity>(entity)) != mEntities.end();
+	if(entity == nullptr)
+	{
+		return false;
+	}
+
+	auto position = GetPosition(entity->mIndex);
+
+	return position != InvalidPosition && mEntities[position] == entity;
 }
 
-void Pool::DestroyEntity(EntityPtr entity)
+bool Pool::HasEntity(const EntityId id) const
 {
-	auto removed = mEntities.erase(entity);
+	return IsValid(id);
+}
+
+bool Pool::IsValid(const EntityId id) const
+{
+	return id.index < mEntityTable.size() && mEntityTable[id.index]->mVersion == id.version && mEntityTable[id.index]->mIsEnabled;
+}
 
-	if (! removed)
+auto Pool::GetEntity(const EntityId id) const -> Entity*
+{
+	return IsValid(id) ? mEntityTable[id.index] : nullptr;
+}
+
+void Pool::DestroyEntity(EntityPtr entity)
+{
+	if (! HasEntity(entity))
 	{
 		ThrowRuntimeError("Error, cannot destroy entity (%u). Pool does not contain entity.", entity->GetUuid());
 	}
 
-	mEntitiesCache.clear();
+	if(mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot destroy entity (%u), the pool is being iterated in parallel. Use the command buffer instead.", entity->GetUuid());
+	}
 
-	OnEntityWillBeDestroyed(this, entity);
-	entity->Destroy();
-	OnEntityDestroyed(this, entity);
+	RemoveFromEntities(entity);
+	Destroy(std::move(entity));
+}
 
-	if (entity.use_count() == 1)
+void Pool::DestroyEntity(const EntityId id)
+{
+	if (! IsValid(id))
 	{
-		entity->OnEntityReleased -= mOnEntityReleasedCache;
-		mReusableEntities.push(entity.get());
+		ThrowRuntimeError("Error, cannot destroy entity (index %u, version %u). Pool does not contain entity.", id.index, id.version);
 	}
-	else
+
+	DestroyEntity(mEntityTable[id.index]->mInstance.lock());
+}
+
+void Pool::DestroyEntities(const std::vector<EntityPtr>& entities)
+{
+	if(mLockCount > 0)
 	{
-		mRetainedEntities.insert(entity.get());
+		ThrowRuntimeError("Error, cannot destroy entities, the pool is being iterated in parallel. Use the command buffer instead.");
+	}
+
+	for(const auto &entity : entities)
+	{
+		if (! HasEntity(entity))
+		{
+			ThrowRuntimeError("Error, cannot destroy entity (%u). Pool does not contain entity.", entity->GetUuid());
+		}
+
+		RemoveFromEntities(entity);
+		Destroy(entity);
 	}
 }
 
 void Pool::DestroyAllEntities()
 {
+	if(mLockCount > 0)
+	{
+		ThrowRuntimeError("Error, cannot destroy all entities, the pool is being iterated in parallel. Use the command buffer instead.");
+	}
+
+	// The whole list is released at once, entities created while destroying are destroyed too
+	while(! mEntities.empty())
 	{
-		auto entitiesTemp = std::vector<EntityPtr>(mEntities.begin(), mEntities.end());
+		auto entities = std::move(mEntities);
+		mEntities.clear();
 
-		while(! mEntities.empty())
+		for(const auto &entity : entities)
 		{
-			DestroyEntity(entitiesTemp.back());
-			entitiesTemp.pop_back();
+			mEntityPositions[entity->mIndex] = InvalidPosition;
 		}
-	}
 
-	mEntities.clear();
+		while(! entities.empty())
+		{
+			auto entity = std::move(entities.back());
+			entities.pop_back();
+			Destroy(std::move(entity));
+		}
+	}
 
 	if (! mRetainedEntities.empty())
 	{
@@ -146,12 +298,7 @@ void Pool::DestroyAllEntities()
 
 auto Pool::GetEntities() -> std::vector<EntityPtr>
 {
-	if(mEntitiesCache.empty())
-	{
-		mEntitiesCache = std::vector<EntityPtr>(mEntities.begin(), mEntities.end());
-	}
-
-	return mEntitiesCache;
+	return mEntities;
 }
 
 auto Pool::GetEntities(const Matcher matcher) -> std::vector<EntityPtr>
@@ -167,8 +314,14 @@ auto Pool::GetGroup(Matcher matcher) -> std::shared_ptr<Group>
 
 	if (it == mGroups.end())
 	{
+		if(mLockCount > 0)
+		{
+			ThrowRuntimeError("Error, cannot create group, the pool is being iterated in parallel. Create the group before.");
+		}
+
 		group = std::shared_ptr<Group>(new Group(matcher));
 		group->SetInstance(group);
+		group->mPool = this;
 
 		auto entities = GetEntities();
 
@@ -194,6 +347,23 @@ auto Pool::GetGroup(Matcher matcher) -> std::shared_ptr<Group>
 	return group;
 }
 
+auto Pool::GetArchetypes() const -> const std::vector<Archetype*>&
+{
+	static const std::vector<Archetype*> noArchetypes;
+
+	if(mArchetypeStorage == nullptr)
+	{
+		return noArchetypes;
+	}
+
+	return mArchetypeStorage->GetArchetypes();
+}
+
+auto Pool::GetStorageMode() const -> PoolStorageMode
+{
+	return mStorageMode;
+}
+
 void Pool::ClearGroups()
 {
 	for (const auto &it : mGroups)
@@ -203,6 +373,8 @@ void Pool::ClearGroups()
 	}
 
 	mGroups.clear();
+	mStaticGroups.clear();
+	++mGroupsVersion;
 
 	for (auto &pair : mGroupsForIndex)
 	{
@@ -219,9 +391,12 @@ void Pool::ResetCreationIndex()
 
 void Pool::ClearComponentPool(const ComponentId index)
 {
-	while(! mComponentPools.at(index).empty())
+	auto &componentPool = mComponentPools.at(index);
+
+	while(! componentPool.empty())
 	{
-		mComponentPools.at(index).pop();
+		mComponentAllocators[index]->Release(componentPool.top());
+		componentPool.pop();
 	}
 }
 
@@ -238,6 +413,15 @@ void Pool::Reset()
 	ClearGroups();
 	DestroyAllEntities();
 	ResetCreationIndex();
+	ClearComponentPools();
+
+	for(auto &componentAllocator : mComponentAllocators)
+	{
+		if(componentAllocator != nullptr && componentAllocator->Count() == 0)
+		{
+			componentAllocator->ReleasePages();
+		}
+	}
 }
 
 auto Pool::GetEntityCount() const -> unsigned int
@@ -245,6 +429,11 @@ auto Pool::GetEntityCount() const -> unsigned int
 	return mEntities.size();
 }
 
+auto Pool::GetComponentAllocator(const ComponentId index) const -> const ComponentAllocator*
+{
+	return (index < mComponentAllocators.size() ? mComponentAllocators[index] : nullptr);
+}
+
 auto Pool::GetReusableEntitiesCount() const -> unsigned int
 {
 	return mReusableEntities.size();
@@ -262,6 +451,11 @@ auto Pool::CreateSystem(std::shared_ptr<ISystem> system) -> std::shared_ptr<ISys
 		(std::dynamic_pointer_cast<ISetPoolSystem>(system)->SetPool(this));
 	}
 
+	if(std::dynamic_pointer_cast<IComponentAccess>(system) != nullptr)
+	{
+		(std::dynamic_pointer_cast<IComponentAccess>(system))->mPool = this;
+	}
+
 	if(std::dynamic_pointer_cast<IReactiveSystem>(system) != nullptr)
 	{
 		return std::shared_ptr<ReactiveSystem>(new ReactiveSystem(this, std::dynamic_pointer_cast<IReactiveSystem>(system)));
@@ -277,16 +471,19 @@ auto Pool::CreateSystem(std::shared_ptr<ISystem> system) -> std::shared_ptr<ISys
 
 void Pool::UpdateGroupsComponentAddedOrRemoved(EntityPtr entity, ComponentId index, IComponent* component)
 {
-	if(mGroupsForIndex.find(index) == mGroupsForIndex.end())
+	auto it = mGroupsForIndex.find(index);
+
+	if(it == mGroupsForIndex.end())
 	{
 		return;
 	}
 
-	auto groups = mGroupsForIndex[index];
+	auto &groups = it->second;
 
 	if (groups.size() > 0)
 	{
 		auto events = std::vector<Group::GroupChanged*>();
+		events.reserve(groups.size());
 
 		for (int i = 0, groupsCount = groups.size(); i < groupsCount; ++i)
 		{
@@ -295,27 +492,239 @@ void Pool::UpdateGroupsComponentAddedOrRemoved(EntityPtr entity, ComponentId ind
 
 		for (int i = 0, eventsCount = events.size(); i < eventsCount; ++i)
 		{
-			(*events[i])(groups[i].lock(), entity, index, component);
+			if(events[i] != nullptr)
+			{
+				(*events[i])(groups[i].lock(), entity, index, component);
+			}
+		}
+	}
+}
+
+// The groups fill their caches on first use, so they are filled before several threads read them
+void Pool::BuildGroupCaches()
+{
+	for(const auto &pair : mGroups)
+	{
+		pair.second->GetEntityIds();
+	}
+}
+
+// Several components added or removed at once, each affected group handles the entity only once
+void Pool::UpdateGroupsComponentsAddedOrRemoved(EntityPtr entity, const ComponentIdList& indices, IComponent* const* components)
+{
+	auto groups = std::vector<std::pair<std::shared_ptr<Group>, unsigned int>>();
+	GetGroupsForIndices(indices, groups);
+
+	auto events = std::vector<Group::GroupChanged*>();
+	events.reserve(groups.size());
+
+	for(const auto &pair : groups)
+	{
+		events.push_back(pair.first->HandleEntity(entity));
+	}
+
+	for(unsigned int i = 0, eventsCount = events.size(); i < eventsCount; ++i)
+	{
+		if(events[i] != nullptr)
+		{
+			auto added = (events[i] == &groups[i].first->OnEntityAdded);
+			auto position = GetGroupEventPosition(groups[i].first->GetMatcher(), entity->GetComponentMask(), indices, added, groups[i].second);
+			(*events[i])(groups[i].first, entity, indices[position], components[position]);
 		}
 	}
 }
 
 void Pool::UpdateGroupsComponentReplaced(EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)
 {
-	if(mGroupsForIndex.find(index) == mGroupsForIndex.end())
+	auto it = mGroupsForIndex.find(index);
+
+	if(it == mGroupsForIndex.end())
+	{
+		return;
+	}
+
+	for(const auto &g : it->second)
+	{
+		g.lock()->UpdateEntity(entity, index, previousComponent, newComponent);
+	}
+}
+
+// Every group depending on any of the indices, paired with the position of the first index it uses
+void Pool::GetGroupsForIndices(const ComponentIdList& indices, std::vector<std::pair<std::shared_ptr<Group>, unsigned int>>& groups) const
+{
+	for(unsigned int i = 0, indicesCount = indices.size(); i < indicesCount; ++i)
+	{
+		auto it = mGroupsForIndex.find(indices[i]);
+
+		if(it == mGroupsForIndex.end())
+		{
+			continue;
+		}
+
+		for(const auto &g : it->second)
+		{
+			auto group = g.lock();
+
+			if(std::find_if(groups.begin(), groups.end(), [&](const std::pair<std::shared_ptr<Group>, unsigned int>& pair) { return pair.first == group; }) == groups.end())
+			{
+				groups.push_back(std::make_pair(group, i));
+			}
+		}
+	}
+}
+
+// Position of the component reported with a group event: one the matcher requires that the entity now
+// has (added) or lost (removed), or one the matcher excludes that the entity lost (added) or now has (removed)
+auto Pool::GetGroupEventPosition(const Matcher& matcher, const ComponentMask& mask, const ComponentIdList& indices, const bool added, const unsigned int fallback) -> unsigned int
+{
+	const auto &allOf = matcher.GetAllOfIndices();
+	const auto &anyOf = matcher.GetAnyOfIndices();
+	const auto &noneOf = matcher.GetNoneOfIndices();
+
+	for(unsigned int i = 0, indicesCount = indices.size(); i < indicesCount; ++i)
+	{
+		auto index = indices[i];
+
+		if(std::find(allOf.begin(), allOf.end(), index) != allOf.end() || std::find(anyOf.begin(), anyOf.end(), index) != anyOf.end())
+		{
+			if(mask[index] == added)
+			{
+				return i;
+			}
+		}
+		else if(std::find(noneOf.begin(), noneOf.end(), index) != noneOf.end())
+		{
+			if(mask[index] != added)
+			{
+				return i;
+			}
+		}
+	}
+
+	return fallback;
+}
+
+void Pool::RegisterComponentType(const ComponentId index, const ComponentTypeInfo* type)
+{
+	if(index < mComponentTypes.size() && mComponentTypes[index] != nullptr)
 	{
 		return;
 	}
 
-	if (mGroupsForIndex[index].size() > 0)
+	if(index >= mComponentTypes.size())
+	{
+		mComponentTypes.resize(index + 1, nullptr);
+	}
+
+	mComponentTypes[index] = type;
+
+	if(index >= mComponentAllocators.size())
+	{
+		mComponentAllocators.resize(index + 1, nullptr);
+	}
+
+	mComponentAllocators[index] = new ComponentAllocator(type);
+
+	if(mArchetypeStorage != nullptr)
+	{
+		mArchetypeStorage->RegisterType(index, type);
+	}
+	else if(mStorageMode == PoolStorageMode::SparseSet)
+	{
+		if(index >= mComponentArrays.size())
+		{
+			mComponentArrays.resize(index + 1, nullptr);
+		}
+
+		mComponentArrays[index] = type->createArray();
+	}
+}
+
+auto Pool::GetComponentType(const ComponentId index) const -> const ComponentTypeInfo*
+{
+	if(index >= mComponentTypes.size() || mComponentTypes[index] == nullptr)
+	{
+		ThrowRuntimeError("Error, component type at index %u is not registered in the pool", index);
+	}
+
+	return mComponentTypes[index];
+}
+
+void Pool::RemoveFromEntities(const EntityPtr& entity)
+{
+	// Swap with the last entity to keep the list packed
+	auto position = mEntityPositions[entity->mIndex];
+
+	if(position != mEntities.size() - 1)
+	{
+		mEntities[position] = std::move(mEntities.back());
+		mEntityPositions[mEntities[position]->mIndex] = position;
+	}
+
+	mEntities.pop_back();
+	mEntityPositions[entity->mIndex] = InvalidPosition;
+}
+
+void Pool::Destroy(EntityPtr entity)
+{
+	OnEntityWillBeDestroyed(this, entity);
+
+	// The entity leaves its groups directly, without being matched again for every removed component
+	for(ComponentId index = entity->mComponentMask.size(); index-- > 0;)
 	{
-		for(const auto &g : mGroupsForIndex[index])
+		if(! entity->mComponentMask[index])
+		{
+			continue;
+		}
+
+		auto component = entity->DetachComponent(index);
+		auto it = mGroupsForIndex.find(index);
+
+		if(it != mGroupsForIndex.end())
 		{
-			g.lock()->UpdateEntity(entity, index, previousComponent, newComponent);
+			for(const auto &g : it->second)
+			{
+				auto group = g.lock();
+
+				if(group->RemoveEntitySilently(entity))
+				{
+					group->OnEntityRemoved(group, entity, index, component);
+				}
+			}
 		}
+
+		entity->OnComponentRemoved(entity, index, component);
+	}
+
+	entity->Destroy();
+	OnEntityDestroyed(this, entity);
+
+	// Invalidate the handles of this entity, version 0 is reserved for the null handle
+	if(++entity->mVersion == 0)
+	{
+		entity->mVersion = 1;
+	}
+
+	if (entity.use_count() == 1)
+	{
+		mReusableEntities.push(entity.get());
+	}
+	else
+	{
+		mRetainedEntities.insert(entity.get());
 	}
 }
 
+auto Pool::GetPosition(const unsigned int entityIndex) const -> unsigned int
+{
+	if(entityIndex >= mEntityPositions.size())
+	{
+		return InvalidPosition;
+	}
+
+	return mEntityPositions[entityIndex];
+}
+
 void Pool::OnEntityReleased(Entity* entity)
 {
 	if (entity->mIsEnabled)
@@ -323,7 +732,10 @@ void Pool::OnEntityReleased(Entity* entity)
 		ThrowRuntimeError("Error, cannot release entity (%u). Entity is not destroyed yet.", entity->GetUuid());
 	}
 
-	mRetainedEntities.erase(entity);
-	mReusableEntities.push(entity);
+	// Entities destroyed without other references are already reusable
+	if(mRetainedEntities.erase(entity))
+	{
+		mReusableEntities.push(entity);
+	}
 }
 }
@@ -7,6 +7,9 @@
 #include "../DllExport.hpp"
 #include "Entity.hpp"
 #include "Matcher.hpp"
+#include "ComponentAllocator.hpp"
+#include <atomic>
+#include <limits>
 #include <unordered_map>
 #include <unordered_set>
 
@@ -14,37 +17,71 @@ namespace JuEngine
 {
 class ISystem;
 class Group;
+template <typename... Ts> class EntityView;
+
+// Archetype storage keeps entities with the same component set in contiguous chunks (faster
+// iteration), but component pointers are only valid until the next structural change.
+// SparseSet storage keeps one dense array per component type (cheap add/remove), component
+// pointers are also invalidated when a component of the same type is added or removed.
+enum class PoolStorageMode
+{
+	Pointer,
+	Archetype,
+	SparseSet
+};
 
 class JUENGINEAPI Pool
 {
+	friend class Entity;
+	friend class EntityCommandBuffer;
+	friend class Group;
+	friend class GroupHandle;
+	friend class SystemContainer;
+	template <typename... Ts> friend class EntityView;
+
 	public:
-		Pool(const unsigned int startCreationIndex = 1);
+		Pool(const unsigned int startCreationIndex = 1, const PoolStorageMode storageMode = PoolStorageMode::Pointer);
 		~Pool();
 
 		auto CreateEntity() -> EntityPtr;
+		// The components of the prototype (which can belong to another pool) are copied to every new entity
+		auto CreateEntities(const unsigned int count, const EntityPtr& prototype = nullptr) -> std::vector<EntityPtr>;
 		bool HasEntity(const EntityPtr& entity) const;
+		bool HasEntity(const EntityId id) const;
+		bool IsValid(const EntityId id) const;
+		auto GetEntity(const EntityId id) const -> Entity*;
 		void DestroyEntity(EntityPtr entity);
+		void DestroyEntity(const EntityId id);
+		// Don't pass a list that changes when entities are destroyed (like the list of a group)
+		void DestroyEntities(const std::vector<EntityPtr>& entities);
 		void DestroyAllEntities();
 
 		auto GetEntities() -> std::vector<EntityPtr>;
 		auto GetEntities(const Matcher matcher) -> std::vector<EntityPtr>;
 		auto GetGroup(Matcher matcher) -> std::shared_ptr<Group>;
+		template <typename TMatcher> inline auto GetGroup() -> std::shared_ptr<Group>;
+		template <typename... Ts> inline auto View() -> EntityView<Ts...>;
+		auto GetArchetypes() const -> const std::vector<Archetype*>&;
+		auto GetStorageMode() const -> PoolStorageMode;
 
 		void ClearGroups();
 		void ResetCreationIndex();
 		void ClearComponentPool(const ComponentId index);
 		void ClearComponentPools();
+		// Destroys all the entities and components and frees the component memory
 		void Reset();
 
 		auto GetEntityCount() const -> unsigned int;
 		auto GetReusableEntitiesCount() const -> unsigned int;
 		auto GetRetainedEntitiesCount() const -> unsigned int;
+		// Components of the pointer storage mode and pooled components (nullptr if the type is not used yet)
+		auto GetComponentAllocator(const ComponentId index) const -> const ComponentAllocator*;
 
 		auto CreateSystem(std::shared_ptr<ISystem> system) -> std::shared_ptr<ISystem>;
 		template <typename T> inline auto CreateSystem() -> std::shared_ptr<ISystem>;
 
-		using PoolChanged = Delegate<void(Pool* pool, EntityPtr entity)>;
-		using GroupChanged = Delegate<void(Pool* pool, std::shared_ptr<Group> group)>;
+		using PoolChanged = Delegate<void(Pool* pool, EntityPtr entity), DelegateNoLock>;
+		using GroupChanged = Delegate<void(Pool* pool, std::shared_ptr<Group> group), DelegateNoLock>;
 
 		PoolChanged OnEntityCreated;
 		PoolChanged OnEntityWillBeDestroyed;
@@ -52,24 +89,62 @@ class JUENGINEAPI Pool
 		GroupChanged OnGroupCreated;
 		GroupChanged OnGroupCleared;
 
+		// Position of the entities that are not in the list of the pool (or of a group)
+		static const unsigned int InvalidPosition = std::numeric_limits<unsigned int>::max();
+
 	private:
 		void UpdateGroupsComponentAddedOrRemoved(EntityPtr entity, ComponentId index, IComponent* component);
+		void UpdateGroupsComponentsAddedOrRemoved(EntityPtr entity, const ComponentIdList& indices, IComponent* const* components);
 		void UpdateGroupsComponentReplaced(EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent);
+		void GetGroupsForIndices(const ComponentIdList& indices, std::vector<std::pair<std::shared_ptr<Group>, unsigned int>>& groups) const;
+		static auto GetGroupEventPosition(const Matcher& matcher, const ComponentMask& mask, const ComponentIdList& indices, const bool added, const unsigned int fallback) -> unsigned int;
+		void BuildGroupCaches();
 		void OnEntityReleased(Entity* entity);
+		void RegisterComponentType(const ComponentId index, const ComponentTypeInfo* type);
+		auto GetComponentType(const ComponentId index) const -> const ComponentTypeInfo*;
+		void RemoveFromEntities(const EntityPtr& entity);
+		void Destroy(EntityPtr entity);
+		auto GetPosition(const unsigned int entityIndex) const -> unsigned int;
 
 		unsigned int mCreationIndex;
-		std::unordered_set<EntityPtr> mEntities;
+		std::vector<EntityPtr> mEntities;
+		std::vector<unsigned int> mEntityPositions;
 		std::unordered_map<Matcher, std::shared_ptr<Group>> mGroups;
+		std::vector<std::shared_ptr<Group>> mStaticGroups;
+		unsigned int mGroupsVersion{0};
 		std::stack<Entity*> mReusableEntities;
 		std::unordered_set<Entity*> mRetainedEntities;
 
 		std::map<ComponentId, std::stack<IComponent*>> mComponentPools;
+		std::vector<const ComponentTypeInfo*> mComponentTypes;
+		std::vector<ComponentAllocator*> mComponentAllocators;
+		PoolStorageMode mStorageMode;
+		ArchetypeStorage* mArchetypeStorage{nullptr};
+		std::vector<IComponentArray*> mComponentArrays;
+		std::vector<Entity*> mEntityTable;
 		std::map<ComponentId, std::vector<std::weak_ptr<Group>>> mGroupsForIndex;
-
-		std::vector<EntityPtr> mEntitiesCache;
-		std::function<void(Entity*)> mOnEntityReleasedCache;
+		std::atomic<unsigned int> mLockCount{0};
 };
 
+// Groups of static matchers are found by the index of the matcher type, without hashing
+template <typename TMatcher>
+auto Pool::GetGroup() -> std::shared_ptr<Group>
+{
+	auto index = TMatcher::GetIndex();
+
+	if(index >= mStaticGroups.size())
+	{
+		mStaticGroups.resize(index + 1);
+	}
+
+	if(mStaticGroups[index] == nullptr)
+	{
+		mStaticGroups[index] = GetGroup(TMatcher::Get());
+	}
+
+	return mStaticGroups[index];
+}
+
 template <typename T>
 auto Pool::CreateSystem() -> std::shared_ptr<ISystem>
 {
@@ -6,6 +6,7 @@
 #include "GroupObserver.hpp"
 #include "Pool.hpp"
 #include "TriggerOnEvent.hpp"
+#include <algorithm>
 
 namespace JuEngine
 {
@@ -21,6 +22,7 @@ ReactiveSystem::ReactiveSystem(Pool* pool, std::shared_ptr<IMultiReactiveSystem>
 
 ReactiveSystem::ReactiveSystem(Pool* pool, std::shared_ptr<IReactiveExecuteSystem> subsystem, std::vector<TriggerOnEvent> triggers)
 {
+	mPool = pool;
 	mSubsystem = subsystem;
 
 	if(std::dynamic_pointer_cast<IEnsureComponents>(subsystem) != nullptr)
@@ -38,6 +40,15 @@ ReactiveSystem::ReactiveSystem(Pool* pool, std::shared_ptr<IReactiveExecuteSyste
 		mClearAfterExecute = true;
 	}
 
+	if(std::dynamic_pointer_cast<IEntityIdReactiveSystem>(subsystem) != nullptr)
+	{
+		mIdSubsystem = std::dynamic_pointer_cast<IEntityIdReactiveSystem>(subsystem).get();
+	}
+	else if(std::dynamic_pointer_cast<IGroupEventReactiveSystem>(subsystem) != nullptr)
+	{
+		mEventSubsystem = std::dynamic_pointer_cast<IGroupEventReactiveSystem>(subsystem).get();
+	}
+
 	unsigned int triggersLength = triggers.size();
 	auto groups = std::vector<std::shared_ptr<Group>>(triggersLength);
 	auto eventTypes = std::vector<GroupEventType>(triggersLength);
@@ -49,7 +60,18 @@ ReactiveSystem::ReactiveSystem(Pool* pool, std::shared_ptr<IReactiveExecuteSyste
 		eventTypes[i] = trigger.eventType;
 	}
 
-	mObserver = new GroupObserver(groups, eventTypes);
+	auto mode = GroupObserverMode::Entities;
+
+	if(mIdSubsystem != nullptr)
+	{
+		mode = GroupObserverMode::EntityIds;
+	}
+	else if(mEventSubsystem != nullptr)
+	{
+		mode = GroupObserverMode::Events;
+	}
+
+	mObserver = new GroupObserver(groups, eventTypes, mode);
 }
 
 ReactiveSystem::~ReactiveSystem ()
@@ -80,61 +102,113 @@ void ReactiveSystem::Clear()
 
 void ReactiveSystem::Execute()
 {
-	if(mObserver->GetCollectedEntities().size() != 0)
+	if(mIdSubsystem != nullptr)
+	{
+		ExecuteIds();
+		return;
+	}
+
+	if(mEventSubsystem != nullptr)
+	{
+		ExecuteEvents();
+		return;
+	}
+
+	if(mObserver->GetCollectedEntities().empty())
+	{
+		return;
+	}
+
+	mObserver->SwapCollectedEntities(mEntityBuffer);
+
+	if(! mEnsureComponents.IsEmpty() || ! mExcludeComponents.IsEmpty())
 	{
-		if(! mEnsureComponents.IsEmpty())
+		mEntityBuffer.erase(std::remove_if(mEntityBuffer.begin(), mEntityBuffer.end(), [this](const EntityPtr& entity)
 		{
-			if(! mExcludeComponents.IsEmpty())
-			{
-				for(const auto &e : mObserver->GetCollectedEntities())
-				{
-					if(mEnsureComponents.Matches(e) && ! mExcludeComponents.Matches(e))
-					{
-						mEntityBuffer.push_back(e);
-					}
-				}
-			}
-			else
-			{
-				for(const auto &e : mObserver->GetCollectedEntities())
-				{
-					if(mEnsureComponents.Matches(e))
-					{
-						mEntityBuffer.push_back(e);
-					}
-				}
-			}
-		}
-		else if(! mExcludeComponents.IsEmpty())
+			return ! Accepts(entity->GetComponentMask());
+		}), mEntityBuffer.end());
+	}
+
+	if(! mEntityBuffer.empty())
+	{
+		mSubsystem->Execute(EntitySpan(mEntityBuffer));
+
+		if(mClearAfterExecute)
 		{
-			for(const auto &e : mObserver->GetCollectedEntities())
-			{
-				if(! mExcludeComponents.Matches(e))
-				{
-					mEntityBuffer.push_back(e);
-				}
-			}
+			mObserver->ClearCollectedEntities();
 		}
-		else
+	}
+
+	// The capacity is kept, the buffers of the system and the observer are reused alternately
+	mEntityBuffer.clear();
+}
+
+void ReactiveSystem::ExecuteIds()
+{
+	if(mObserver->GetCollectedEntityIds().empty())
+	{
+		return;
+	}
+
+	mObserver->SwapCollectedEntityIds(mEntityIdBuffer);
+
+	mEntityIdBuffer.erase(std::remove_if(mEntityIdBuffer.begin(), mEntityIdBuffer.end(), [this](const EntityId& id)
+	{
+		auto entity = mPool->GetEntity(id);
+
+		return entity == nullptr || ! Accepts(entity->GetComponentMask());
+	}), mEntityIdBuffer.end());
+
+	if(! mEntityIdBuffer.empty())
+	{
+		mIdSubsystem->ExecuteIds(mEntityIdBuffer);
+
+		if(mClearAfterExecute)
 		{
-			for(const auto &e : mObserver->GetCollectedEntities())
-			{
-				mEntityBuffer.push_back(e);
-			}
+			mObserver->ClearCollectedEntities();
 		}
+	}
 
-		mObserver->ClearCollectedEntities();
+	mEntityIdBuffer.clear();
+}
 
-		if(mEntityBuffer.size() != 0)
+void ReactiveSystem::ExecuteEvents()
+{
+	if(mObserver->GetCollectedEvents().empty())
+	{
+		return;
+	}
+
+	mObserver->SwapCollectedEvents(mEventBuffer);
+
+	if(! mEnsureComponents.IsEmpty() || ! mExcludeComponents.IsEmpty())
+	{
+		mEventBuffer.erase(std::remove_if(mEventBuffer.begin(), mEventBuffer.end(), [this](const GroupEvent& event)
 		{
-			mSubsystem->Execute(mEntityBuffer);
-			mEntityBuffer.clear();
+			return ! Accepts(event.entity->GetComponentMask());
+		}), mEventBuffer.end());
+	}
 
-			if(mClearAfterExecute)
-			{
-				mObserver->ClearCollectedEntities();
-			}
+	if(! mEventBuffer.empty())
+	{
+		mEventSubsystem->ExecuteEvents(Span<const GroupEvent>(mEventBuffer));
+
+		if(mClearAfterExecute)
+		{
+			mObserver->ClearCollectedEntities();
 		}
 	}
+
+	mEventBuffer.clear();
+}
+
+bool ReactiveSystem::Accepts(const ComponentMask& mask) const
+{
+	if(! mEnsureComponents.IsEmpty() && ! mEnsureComponents.Matches(mask))
+	{
+		return false;
+	}
+
+	return mExcludeComponents.IsEmpty() || ! mExcludeComponents.Matches(mask);
 }
 }
@@ -26,11 +26,21 @@ class JUENGINEAPI ReactiveSystem : public IExecuteSystem
 		void Execute();
 
 	private:
+		void ExecuteIds();
+		void ExecuteEvents();
+		bool Accepts(const ComponentMask& mask) const;
+
+		Pool* mPool;
 		std::shared_ptr<IReactiveExecuteSystem> mSubsystem;
+		IEntityIdReactiveSystem* mIdSubsystem{nullptr};
+		IGroupEventReactiveSystem* mEventSubsystem{nullptr};
 		GroupObserver* mObserver;
 		Matcher mEnsureComponents;
 		Matcher mExcludeComponents;
 		bool mClearAfterExecute{false};
+		// Swapped with the collection buffer of the observer on every execution
 		std::vector<EntityPtr> mEntityBuffer;
+		std::vector<EntityId> mEntityIdBuffer;
+		std::vector<GroupEvent> mEventBuffer;
 };
 }
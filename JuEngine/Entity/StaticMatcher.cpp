@@ -0,0 +1,15 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "StaticMatcher.hpp"
+
+namespace JuEngine
+{
+unsigned int StaticMatcherIndex::mCounter = 0;
+
+auto StaticMatcherIndex::Next() -> unsigned int
+{
+	return mCounter++;
+}
+}
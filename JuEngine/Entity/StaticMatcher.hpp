@@ -0,0 +1,126 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Matcher.hpp"
+
+namespace JuEngine
+{
+template <typename... Ts> struct AllOf {};
+template <typename... Ts> struct AnyOf {};
+template <typename... Ts> struct NoneOf {};
+
+namespace StaticMatcherImpl
+{
+template <typename... Ts>
+struct Bits
+{
+	static const unsigned long long Value = 0;
+};
+
+template <typename T, typename... Ts>
+struct Bits<T, Ts...>
+{
+	static_assert(StaticComponentId<T>::IsDefined, "StaticMatcher components must have a static id (see JUENGINE_COMPONENT_ID)");
+	static_assert(StaticComponentId<T>::Value < 64, "StaticMatcher components must have a static id lower than 64");
+
+	static const unsigned long long Value = (1ull << StaticComponentId<T>::Value) | Bits<Ts...>::Value;
+};
+
+template <typename TClause>
+struct Clause
+{
+	static_assert(sizeof(TClause) == 0, "StaticMatcher arguments must be AllOf, AnyOf or NoneOf");
+};
+
+template <typename... Ts>
+struct Clause<AllOf<Ts...>>
+{
+	static const unsigned long long AllOfBits = Bits<Ts...>::Value;
+	static const unsigned long long AnyOfBits = 0;
+	static const unsigned long long NoneOfBits = 0;
+};
+
+template <typename... Ts>
+struct Clause<AnyOf<Ts...>>
+{
+	static const unsigned long long AllOfBits = 0;
+	static const unsigned long long AnyOfBits = Bits<Ts...>::Value;
+	static const unsigned long long NoneOfBits = 0;
+};
+
+template <typename... Ts>
+struct Clause<NoneOf<Ts...>>
+{
+	static const unsigned long long AllOfBits = 0;
+	static const unsigned long long AnyOfBits = 0;
+	static const unsigned long long NoneOfBits = Bits<Ts...>::Value;
+};
+
+template <typename... TClauses>
+struct Clauses
+{
+	static const unsigned long long AllOfBits = 0;
+	static const unsigned long long AnyOfBits = 0;
+	static const unsigned long long NoneOfBits = 0;
+};
+
+template <typename TClause, typename... TClauses>
+struct Clauses<TClause, TClauses...>
+{
+	static const unsigned long long AllOfBits = Clause<TClause>::AllOfBits | Clauses<TClauses...>::AllOfBits;
+	static const unsigned long long AnyOfBits = Clause<TClause>::AnyOfBits | Clauses<TClauses...>::AnyOfBits;
+	static const unsigned long long NoneOfBits = Clause<TClause>::NoneOfBits | Clauses<TClauses...>::NoneOfBits;
+};
+}
+
+struct JUENGINEAPI StaticMatcherIndex
+{
+	public:
+		static auto Next() -> unsigned int;
+
+	private:
+		static unsigned int mCounter;
+};
+
+// Matcher resolved at compile time (like StaticMatcher<AllOf<Transform, Camera>, NoneOf<Light>>),
+// only for components with a static id. Pool::GetGroup<TMatcher>() finds its group by index.
+template <typename... TClauses>
+struct StaticMatcher
+{
+	static const unsigned long long AllOfBits = StaticMatcherImpl::Clauses<TClauses...>::AllOfBits;
+	static const unsigned long long AnyOfBits = StaticMatcherImpl::Clauses<TClauses...>::AnyOfBits;
+	static const unsigned long long NoneOfBits = StaticMatcherImpl::Clauses<TClauses...>::NoneOfBits;
+
+	static inline bool Matches(const ComponentMask& mask);
+	static inline auto Get() -> const Matcher&;
+	static inline auto GetIndex() -> unsigned int;
+};
+
+template <typename... TClauses>
+bool StaticMatcher<TClauses...>::Matches(const ComponentMask& mask)
+{
+	const ComponentMask allOfMask(AllOfBits);
+
+	return (mask & allOfMask) == allOfMask && (AnyOfBits == 0 || (mask & ComponentMask(AnyOfBits)).any()) && (mask & ComponentMask(NoneOfBits)).none();
+}
+
+template <typename... TClauses>
+auto StaticMatcher<TClauses...>::Get() -> const Matcher&
+{
+	static const Matcher matcher = Matcher::Create(ComponentTypeId::GetIndices(ComponentMask(AllOfBits)),
+		ComponentTypeId::GetIndices(ComponentMask(AnyOfBits)), ComponentTypeId::GetIndices(ComponentMask(NoneOfBits)));
+
+	return matcher;
+}
+
+template <typename... TClauses>
+auto StaticMatcher<TClauses...>::GetIndex() -> unsigned int
+{
+	static const unsigned int index = StaticMatcherIndex::Next();
+
+	return index;
+}
+}
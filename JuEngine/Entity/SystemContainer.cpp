@@ -4,9 +4,23 @@
 
 #include "SystemContainer.hpp"
 #include "ReactiveSystem.hpp"
+#include "EntityCommandBuffer.hpp"
+#include "Pool.hpp"
+#include "../Services/IJobService.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <exception>
 
 namespace JuEngine
 {
+struct SystemSchedule
+{
+	std::mutex mutex;
+	std::vector<unsigned int> dependencyCounts;
+	std::exception_ptr exception;
+	JobCounter counter;
+};
+
 auto SystemContainer::Add(std::shared_ptr<ISystem> system) -> SystemContainer*
 {
 	if(std::dynamic_pointer_cast<ReactiveSystem>(system) != nullptr)
@@ -27,16 +41,45 @@ auto SystemContainer::Add(std::shared_ptr<ISystem> system) -> SystemContainer*
 	if(std::dynamic_pointer_cast<IExecuteSystem>(system) != nullptr)
 	{
 		mExecuteSystems.push_back(std::dynamic_pointer_cast<IExecuteSystem>(system));
+		AddToGraph(mExecuteGraph, system);
 	}
 
 	if(std::dynamic_pointer_cast<IFixedExecuteSystem>(system) != nullptr)
 	{
 		mFixedExecuteSystems.push_back(std::dynamic_pointer_cast<IFixedExecuteSystem>(system));
+		AddToGraph(mFixedExecuteGraph, system);
 	}
 
+	if(std::dynamic_pointer_cast<SystemContainer>(system) != nullptr && mJobService != nullptr)
+	{
+		(std::dynamic_pointer_cast<SystemContainer>(system))->SetJobService(mJobService);
+	}
+
+	return this;
+}
+
+// The command buffers are played back after all the systems have been executed
+auto SystemContainer::AddCommandBuffer(std::shared_ptr<EntityCommandBuffer> commandBuffer) -> SystemContainer*
+{
+	mCommandBuffers.push_back(commandBuffer);
+
 	return this;
 }
 
+// Nested containers use the same job service
+void SystemContainer::SetJobService(IJobService* jobService)
+{
+	mJobService = jobService;
+
+	for(const auto &system : mExecuteSystems)
+	{
+		if(std::dynamic_pointer_cast<SystemContainer>(system) != nullptr)
+		{
+			(std::dynamic_pointer_cast<SystemContainer>(system))->SetJobService(jobService);
+		}
+	}
+}
+
 void SystemContainer::Initialize()
 {
 	for(const auto &system : mInitializeSystems)
@@ -47,18 +90,22 @@ void SystemContainer::Initialize()
 
 void SystemContainer::Execute()
 {
-	for(const auto &system : mExecuteSystems)
+	Run(mExecuteSystems, mExecuteGraph, [](const std::shared_ptr<IExecuteSystem>& system)
 	{
 		system->Execute();
-	}
+	});
+
+	PlaybackCommandBuffers();
 }
 
 void SystemContainer::FixedExecute()
 {
-	for(const auto &system : mFixedExecuteSystems)
+	Run(mFixedExecuteSystems, mFixedExecuteGraph, [](const std::shared_ptr<IFixedExecuteSystem>& system)
 	{
 		system->FixedExecute();
-	}
+	});
+
+	PlaybackCommandBuffers();
 }
 
 void SystemContainer::ActivateReactiveSystems()
@@ -108,4 +155,174 @@ void SystemContainer::ClearReactiveSystems()
 		}
 	}
 }
+
+void SystemContainer::PlaybackCommandBuffers()
+{
+	for(const auto &commandBuffer : mCommandBuffers)
+	{
+		commandBuffer->Playback();
+	}
+}
+
+void SystemContainer::AddToGraph(SystemGraph& graph, const std::shared_ptr<ISystem>& system)
+{
+	auto access = std::dynamic_pointer_cast<IComponentAccess>(system);
+
+	if(access == nullptr && std::dynamic_pointer_cast<ReactiveSystem>(system) != nullptr)
+	{
+		access = std::dynamic_pointer_cast<IComponentAccess>((std::dynamic_pointer_cast<ReactiveSystem>(system))->GetSubsystem());
+	}
+
+	ComponentMask readMask;
+	ComponentMask writeMask;
+
+	if(access != nullptr)
+	{
+		if(access->mPool == nullptr)
+		{
+			ThrowRuntimeError("Error, systems declaring their component access must be created with Pool::CreateSystem.");
+		}
+
+		for(const auto &index : access->readComponents.GetIndices())
+		{
+			readMask.set(index);
+		}
+
+		for(const auto &index : access->writeComponents.GetIndices())
+		{
+			writeMask.set(index);
+		}
+
+		++graph.declaredCount;
+
+		if(std::find(graph.distinctPools.begin(), graph.distinctPools.end(), access->mPool) == graph.distinctPools.end())
+		{
+			graph.distinctPools.push_back(access->mPool);
+		}
+	}
+
+	const unsigned int systemIndex = graph.declared.size();
+
+	graph.declared.push_back(access != nullptr);
+	graph.pools.push_back(access != nullptr ? access->mPool : nullptr);
+	graph.readMasks.push_back(readMask);
+	graph.writeMasks.push_back(writeMask);
+	graph.dependents.push_back(std::vector<unsigned int>());
+	graph.dependencyCounts.push_back(0);
+
+	for(unsigned int i = 0; i < systemIndex; ++i)
+	{
+		if(! graph.declared[i] || access == nullptr || (graph.writeMasks[i] & (readMask | writeMask)).any() || (graph.readMasks[i] & writeMask).any())
+		{
+			graph.dependents[i].push_back(systemIndex);
+			++graph.dependencyCounts[systemIndex];
+		}
+	}
+}
+
+// Each system runs as a job, the job of a system starts the systems that become ready after it
+template <typename TSystem, typename TFunction>
+void SystemContainer::Run(const std::vector<std::shared_ptr<TSystem>>& systems, const SystemGraph& graph, TFunction function)
+{
+	if(mJobService == nullptr || mJobService->GetWorkerCount() == 0 || graph.declaredCount < 2)
+	{
+		for(const auto &system : systems)
+		{
+			function(system);
+		}
+
+		return;
+	}
+
+	SystemSchedule schedule;
+	schedule.dependencyCounts = graph.dependencyCounts;
+
+	for(const auto &pool : graph.distinctPools)
+	{
+		pool->BuildGroupCaches();
+	}
+
+	std::function<void(const unsigned int)> runSystem = [&](const unsigned int index)
+	{
+		try
+		{
+			RunLocked(graph.pools[index], [&]()
+			{
+				function(systems[index]);
+			});
+		}
+		catch(...)
+		{
+			std::lock_guard<std::mutex> lock(schedule.mutex);
+			schedule.exception = (schedule.exception != nullptr ? schedule.exception : std::current_exception());
+		}
+
+		// The systems without declared access run alone and can change the groups
+		if(! graph.declared[index])
+		{
+			for(const auto &pool : graph.distinctPools)
+			{
+				pool->BuildGroupCaches();
+			}
+		}
+
+		std::lock_guard<std::mutex> lock(schedule.mutex);
+
+		for(const auto &dependent : graph.dependents[index])
+		{
+			if(--schedule.dependencyCounts[dependent] == 0)
+			{
+				mJobService->Run([&runSystem, dependent]()
+				{
+					runSystem(dependent);
+				}, &schedule.counter);
+			}
+		}
+	};
+
+	for(unsigned int i = 0, count = systems.size(); i < count; ++i)
+	{
+		if(graph.dependencyCounts[i] == 0)
+		{
+			mJobService->Run([&runSystem, i]()
+			{
+				runSystem(i);
+			}, &schedule.counter);
+		}
+	}
+
+	mJobService->Wait(schedule.counter);
+
+	if(schedule.exception != nullptr)
+	{
+		std::rethrow_exception(schedule.exception);
+	}
+}
+
+// Systems running concurrently hold the lock of their pool, so the changes that would notify the
+// groups from several threads are rejected (like in Group::ParallelForRanges)
+template <typename TFunction>
+void SystemContainer::RunLocked(Pool* pool, TFunction function)
+{
+	if(pool == nullptr)
+	{
+		function();
+
+		return;
+	}
+
+	++pool->mLockCount;
+
+	try
+	{
+		function();
+	}
+	catch(...)
+	{
+		--pool->mLockCount;
+		throw;
+	}
+
+	--pool->mLockCount;
+}
 }
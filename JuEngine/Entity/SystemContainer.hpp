@@ -10,6 +10,9 @@
 
 namespace JuEngine
 {
+class EntityCommandBuffer;
+class IJobService;
+
 class JUENGINEAPI SystemContainer : public IInitializeSystem, public IExecuteSystem, public IFixedExecuteSystem
 {
 	public:
@@ -17,6 +20,9 @@ class JUENGINEAPI SystemContainer : public IInitializeSystem, public IExecuteSys
 
 		auto Add(std::shared_ptr<ISystem> system) -> SystemContainer*;
 		template <typename T> inline auto Add() -> SystemContainer*;
+		auto AddCommandBuffer(std::shared_ptr<EntityCommandBuffer> commandBuffer) -> SystemContainer*;
+		// Without a job service (default) the systems are executed sequentially in the adding order
+		void SetJobService(IJobService* jobService);
 
 		void Initialize();
 		void Execute();
@@ -25,11 +31,34 @@ class JUENGINEAPI SystemContainer : public IInitializeSystem, public IExecuteSys
 		void ActivateReactiveSystems();
 		void DeactivateReactiveSystems();
 		void ClearReactiveSystems();
+		void PlaybackCommandBuffers();
 
 	private:
+		// Each system depends on the previous systems it conflicts with (the systems that don't
+		// declare their component access conflict with all of them)
+		struct SystemGraph
+		{
+			std::vector<bool> declared;
+			std::vector<Pool*> pools;
+			std::vector<Pool*> distinctPools;
+			std::vector<ComponentMask> readMasks;
+			std::vector<ComponentMask> writeMasks;
+			std::vector<std::vector<unsigned int>> dependents;
+			std::vector<unsigned int> dependencyCounts;
+			unsigned int declaredCount{0};
+		};
+
+		static void AddToGraph(SystemGraph& graph, const std::shared_ptr<ISystem>& system);
+		template <typename TSystem, typename TFunction> void Run(const std::vector<std::shared_ptr<TSystem>>& systems, const SystemGraph& graph, TFunction function);
+		template <typename TFunction> static void RunLocked(Pool* pool, TFunction function);
+
 		std::vector<std::shared_ptr<IInitializeSystem>> mInitializeSystems;
 		std::vector<std::shared_ptr<IExecuteSystem>> mExecuteSystems;
 		std::vector<std::shared_ptr<IFixedExecuteSystem>> mFixedExecuteSystems;
+		std::vector<std::shared_ptr<EntityCommandBuffer>> mCommandBuffers;
+		SystemGraph mExecuteGraph;
+		SystemGraph mFixedExecuteGraph;
+		IJobService* mJobService{nullptr};
 };
 
 template <typename T>
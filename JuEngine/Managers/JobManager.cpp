@@ -0,0 +1,220 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "JobManager.hpp"
+
+namespace JuEngine
+{
+static thread_local const JobManager* tJobManager = nullptr;
+static thread_local unsigned int tQueueIndex = 0;
+
+// The thread that submits the jobs also executes them while waiting, so one core is left for it
+JobManager::JobManager() : JobManager(std::max(std::thread::hardware_concurrency(), 2u) - 1)
+{
+}
+
+JobManager::JobManager(const unsigned int workerCount)
+{
+	SetId("jobManager");
+
+	// The queue 0 is shared by the threads that aren't workers
+	for(unsigned int i = 0; i <= workerCount; ++i)
+	{
+		mQueues.push_back(std::unique_ptr<WorkQueue>(new WorkQueue()));
+	}
+
+	for(unsigned int i = 0; i < workerCount; ++i)
+	{
+		mThreads.push_back(std::thread(&JobManager::Work, this, i + 1));
+	}
+}
+
+JobManager::~JobManager()
+{
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+		mStopping = true;
+	}
+
+	mSleepCondition.notify_all();
+
+	for(auto &thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+void JobManager::Run(Job job, JobCounter* counter, JobCounter* dependency)
+{
+	if(counter != nullptr)
+	{
+		++counter->mCount;
+	}
+
+	if(dependency != nullptr)
+	{
+		std::lock_guard<std::mutex> lock(dependency->mMutex);
+
+		if(! dependency->IsDone())
+		{
+			dependency->mContinuations.push_back(std::make_pair(std::move(job), counter));
+
+			return;
+		}
+	}
+
+	Push({ std::move(job), counter });
+}
+
+void JobManager::Wait(JobCounter& counter)
+{
+	while(! counter.IsDone())
+	{
+		if(! RunNext())
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	// The last job could still be signaling the counter
+	std::lock_guard<std::mutex> lock(counter.mMutex);
+}
+
+auto JobManager::GetWorkerCount() const -> unsigned int
+{
+	return mThreads.size();
+}
+
+void JobManager::Push(Task task)
+{
+	auto &queue = *mQueues[GetQueueIndex()];
+
+	{
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(std::move(task));
+		++mPendingCount;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(mSleepMutex);
+	}
+
+	mSleepCondition.notify_one();
+}
+
+bool JobManager::Pop(const unsigned int queueIndex, Task& task)
+{
+	auto &queue = *mQueues[queueIndex];
+	std::lock_guard<std::mutex> lock(queue.mutex);
+
+	if(queue.tasks.empty())
+	{
+		return false;
+	}
+
+	task = std::move(queue.tasks.back());
+	queue.tasks.pop_back();
+	--mPendingCount;
+
+	return true;
+}
+
+bool JobManager::Steal(const unsigned int queueIndex, Task& task)
+{
+	for(unsigned int i = 1, queueCount = mQueues.size(); i < queueCount; ++i)
+	{
+		auto &queue = *mQueues[(queueIndex + i) % queueCount];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+
+		if(! queue.tasks.empty())
+		{
+			task = std::move(queue.tasks.front());
+			queue.tasks.pop_front();
+			--mPendingCount;
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+bool JobManager::RunNext()
+{
+	Task task;
+	auto queueIndex = GetQueueIndex();
+
+	if(Pop(queueIndex, task) || Steal(queueIndex, task))
+	{
+		Execute(task);
+
+		return true;
+	}
+
+	return false;
+}
+
+void JobManager::Execute(Task& task)
+{
+	task.job();
+
+	// The captures of the job are released before the waiting threads continue
+	task.job = nullptr;
+
+	if(task.counter != nullptr)
+	{
+		Signal(task.counter);
+	}
+}
+
+void JobManager::Signal(JobCounter* counter)
+{
+	std::vector<std::pair<Job, JobCounter*>> continuations;
+
+	{
+		std::lock_guard<std::mutex> lock(counter->mMutex);
+
+		if(--counter->mCount == 0)
+		{
+			continuations.swap(counter->mContinuations);
+		}
+	}
+
+	for(auto &continuation : continuations)
+	{
+		Push({ std::move(continuation.first), continuation.second });
+	}
+}
+
+void JobManager::Work(const unsigned int queueIndex)
+{
+	tJobManager = this;
+	tQueueIndex = queueIndex;
+
+	while(true)
+	{
+		if(RunNext())
+		{
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(mSleepMutex);
+
+		mSleepCondition.wait(lock, [this]()
+		{
+			return mStopping || mPendingCount.load() > 0;
+		});
+
+		if(mStopping && mPendingCount.load() == 0)
+		{
+			return;
+		}
+	}
+}
+
+auto JobManager::GetQueueIndex() const -> unsigned int
+{
+	return (tJobManager == this ? tQueueIndex : 0);
+}
+}
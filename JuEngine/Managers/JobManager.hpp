@@ -0,0 +1,57 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../Services/IJobService.hpp"
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <thread>
+
+namespace JuEngine
+{
+// Each worker takes the jobs from the back of its own queue and steals them from the front of
+// the other queues when it runs out of work. The threads that aren't workers share a queue.
+class JUENGINEAPI JobManager : public IJobService
+{
+	public:
+		JobManager();
+		JobManager(const unsigned int workerCount);
+		~JobManager();
+
+		void Run(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr);
+		void Wait(JobCounter& counter);
+		auto GetWorkerCount() const -> unsigned int;
+
+	private:
+		struct Task
+		{
+			Job job;
+			JobCounter* counter;
+		};
+
+		struct WorkQueue
+		{
+			std::mutex mutex;
+			std::deque<Task> tasks;
+		};
+
+		void Push(Task task);
+		bool Pop(const unsigned int queueIndex, Task& task);
+		bool Steal(const unsigned int queueIndex, Task& task);
+		bool RunNext();
+		void Execute(Task& task);
+		void Signal(JobCounter* counter);
+		void Work(const unsigned int queueIndex);
+		auto GetQueueIndex() const -> unsigned int;
+
+		std::vector<std::unique_ptr<WorkQueue>> mQueues;
+		std::vector<std::thread> mThreads;
+		std::atomic<unsigned int> mPendingCount{0};
+		std::mutex mSleepMutex;
+		std::condition_variable mSleepCondition;
+		bool mStopping{false};
+};
+}
@@ -9,6 +9,7 @@
 #include "../Resources/Timer.hpp"
 #include "../App.hpp"
 #include "../Services/IDataService.hpp"
+#include "../Services/ISpatialService.hpp"
 #include "../Services/ISystemService.hpp"
 #include "../Services/IWindowService.hpp"
 
@@ -116,6 +117,7 @@ void LevelManager::LoadLevelAdditive(const Identifier& id)
 void LevelManager::UnloadLevel()
 {
 	App::System()->Reset();
+	App::Spatial()->Reset();
 	App::Data()->DeleteAll<Pool>();
 	App::Window()->GetRenderer()->Reset();
 	App::Data()->DeleteAll<Timer>();
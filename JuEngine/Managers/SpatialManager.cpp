@@ -0,0 +1,97 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "SpatialManager.hpp"
+#include "../App.hpp"
+
+namespace JuEngine
+{
+SpatialManager::SpatialManager()
+{
+	SetId("spatialManager");
+}
+
+void SpatialManager::Register(Pool* pool)
+{
+	for(const auto &index : mIndices)
+	{
+		if(index->GetPool() == pool)
+		{
+			App::Log()->Warning("Warning: SpatialManager.Register: The pool is registered already");
+
+			return;
+		}
+	}
+
+	mIndices.emplace_back(new SpatialIndex(pool));
+}
+
+void SpatialManager::Reset()
+{
+	mIndices.clear();
+}
+
+void SpatialManager::Update()
+{
+	for(const auto &index : mIndices)
+	{
+		index->Update();
+	}
+}
+
+void SpatialManager::Invalidate(const EntityPtr& entity)
+{
+	for(const auto &index : mIndices)
+	{
+		index->Invalidate(entity);
+	}
+}
+
+void SpatialManager::Query(const BoundingBox& box, std::vector<EntityPtr>& entities)
+{
+	entities.clear();
+
+	for(const auto &index : mIndices)
+	{
+		index->Query(box, entities);
+	}
+}
+
+void SpatialManager::Query(const BoundingSphere& sphere, std::vector<EntityPtr>& entities)
+{
+	entities.clear();
+
+	for(const auto &index : mIndices)
+	{
+		index->Query(sphere, entities);
+	}
+}
+
+void SpatialManager::Query(const Frustum& frustum, std::vector<EntityPtr>& entities)
+{
+	entities.clear();
+
+	for(const auto &index : mIndices)
+	{
+		index->Query(frustum, entities);
+	}
+}
+
+auto SpatialManager::Raycast(const vec3& origin, const vec3& direction, const float maxDistance, RaycastHit& hit) -> bool
+{
+	RaycastHit indexHit;
+	bool found = false;
+
+	for(const auto &index : mIndices)
+	{
+		if(index->Raycast(origin, direction, maxDistance, indexHit) && (! found || indexHit.distance < hit.distance))
+		{
+			hit = indexHit;
+			found = true;
+		}
+	}
+
+	return found;
+}
+}
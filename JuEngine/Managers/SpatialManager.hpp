@@ -0,0 +1,31 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../Services/ISpatialService.hpp"
+#include <memory>
+
+namespace JuEngine
+{
+// One spatial index per registered pool, the queries merge the results of all of them
+class JUENGINEAPI SpatialManager : public ISpatialService
+{
+	public:
+		SpatialManager();
+
+		void Register(Pool* pool);
+		void Reset();
+		void Update();
+		void Invalidate(const EntityPtr& entity);
+
+		void Query(const BoundingBox& box, std::vector<EntityPtr>& entities);
+		void Query(const BoundingSphere& sphere, std::vector<EntityPtr>& entities);
+		void Query(const Frustum& frustum, std::vector<EntityPtr>& entities);
+		auto Raycast(const vec3& origin, const vec3& direction, const float maxDistance, RaycastHit& hit) -> bool;
+
+	private:
+		std::vector<std::unique_ptr<SpatialIndex>> mIndices;
+};
+}
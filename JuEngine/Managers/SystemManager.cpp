@@ -4,6 +4,7 @@
 
 #include "SystemManager.hpp"
 #include "../Entity/SystemContainer.hpp"
+#include "../App.hpp"
 
 namespace JuEngine
 {
@@ -37,5 +38,6 @@ void SystemManager::FixedExecute()
 void SystemManager::Reset()
 {
 	mSystemContainer = std::shared_ptr<SystemContainer>(new SystemContainer());
+	mSystemContainer->SetJobService(App::Jobs());
 }
 }
@@ -0,0 +1,203 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "BoundingVolume.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace JuEngine
+{
+void BoundingBox::Encapsulate(const vec3& point)
+{
+	if(IsEmpty())
+	{
+		min = point;
+		max = point;
+
+		return;
+	}
+
+	min = glm::min(min, point);
+	max = glm::max(max, point);
+}
+
+void BoundingBox::Encapsulate(const BoundingBox& box)
+{
+	if(box.IsEmpty())
+	{
+		return;
+	}
+
+	Encapsulate(box.min);
+	Encapsulate(box.max);
+}
+
+auto BoundingBox::IsEmpty() const -> bool
+{
+	return (min.x > max.x || min.y > max.y || min.z > max.z);
+}
+
+auto BoundingBox::GetCenter() const -> vec3
+{
+	return (min + max) * 0.5f;
+}
+
+auto BoundingBox::GetExtents() const -> vec3
+{
+	return (max - min) * 0.5f;
+}
+
+auto BoundingBox::GetSurfaceArea() const -> float
+{
+	if(IsEmpty())
+	{
+		return 0.f;
+	}
+
+	vec3 size = max - min;
+
+	return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+}
+
+auto BoundingBox::Contains(const BoundingBox& box) const -> bool
+{
+	return (! IsEmpty() && ! box.IsEmpty() &&
+		min.x <= box.min.x && min.y <= box.min.y && min.z <= box.min.z &&
+		max.x >= box.max.x && max.y >= box.max.y && max.z >= box.max.z);
+}
+
+auto BoundingBox::Intersects(const BoundingBox& box) const -> bool
+{
+	return (! IsEmpty() && ! box.IsEmpty() &&
+		min.x <= box.max.x && min.y <= box.max.y && min.z <= box.max.z &&
+		max.x >= box.min.x && max.y >= box.min.y && max.z >= box.min.z);
+}
+
+// Slab test, the inverse direction is calculated once per ray (its components are infinite on the
+// axes the ray doesn't move). The distance is zero when the origin is inside the box.
+auto BoundingBox::Intersects(const vec3& origin, const vec3& inverseDirection, const float maxDistance, float& distance) const -> bool
+{
+	if(IsEmpty())
+	{
+		return false;
+	}
+
+	float nearDistance = 0.f;
+	float farDistance = maxDistance;
+
+	for(unsigned int axis = 0; axis < 3; ++axis)
+	{
+		if(std::isinf(inverseDirection[axis]))
+		{
+			if(origin[axis] < min[axis] || origin[axis] > max[axis])
+			{
+				return false;
+			}
+
+			continue;
+		}
+
+		float t0 = (min[axis] - origin[axis]) * inverseDirection[axis];
+		float t1 = (max[axis] - origin[axis]) * inverseDirection[axis];
+
+		if(t0 > t1)
+		{
+			std::swap(t0, t1);
+		}
+
+		nearDistance = (t0 > nearDistance ? t0 : nearDistance);
+		farDistance = (t1 < farDistance ? t1 : farDistance);
+
+		if(nearDistance > farDistance)
+		{
+			return false;
+		}
+	}
+
+	distance = nearDistance;
+
+	return true;
+}
+
+// The extents are projected on the absolute value of the rotation and scale (Arvo's method)
+auto BoundingBox::Transform(const mat4& matrix) const -> BoundingBox
+{
+	if(IsEmpty())
+	{
+		return *this;
+	}
+
+	vec3 center = vec3(matrix * vec4(GetCenter(), 1.f));
+	vec3 extents = GetExtents();
+	vec3 newExtents;
+
+	for(unsigned int row = 0; row < 3; ++row)
+	{
+		newExtents[row] = std::abs(matrix[0][row]) * extents.x + std::abs(matrix[1][row]) * extents.y + std::abs(matrix[2][row]) * extents.z;
+	}
+
+	BoundingBox box;
+	box.min = center - newExtents;
+	box.max = center + newExtents;
+
+	return box;
+}
+
+// The positions are the first three floats of every vertex
+auto BoundingBox::FromPoints(const float* points, const unsigned int count, const unsigned int stride) -> BoundingBox
+{
+	BoundingBox box;
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		const float* point = points + i * stride;
+		box.Encapsulate(vec3(point[0], point[1], point[2]));
+	}
+
+	return box;
+}
+
+auto BoundingSphere::Intersects(const BoundingBox& box) const -> bool
+{
+	if(box.IsEmpty())
+	{
+		return false;
+	}
+
+	vec3 closest = glm::min(glm::max(center, box.min), box.max);
+	vec3 offset = closest - center;
+
+	return (offset.x * offset.x + offset.y * offset.y + offset.z * offset.z <= radius * radius);
+}
+
+// Centered on the box, tighter than the box diagonal because the radius is taken from the points
+auto BoundingSphere::FromPoints(const float* points, const unsigned int count, const unsigned int stride, const BoundingBox& box) -> BoundingSphere
+{
+	BoundingSphere sphere;
+
+	if(box.IsEmpty())
+	{
+		return sphere;
+	}
+
+	float radiusSquared = 0.f;
+	sphere.center = box.GetCenter();
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		const float* point = points + i * stride;
+		vec3 offset = vec3(point[0], point[1], point[2]) - sphere.center;
+		float distanceSquared = offset.x * offset.x + offset.y * offset.y + offset.z * offset.z;
+
+		if(distanceSquared > radiusSquared)
+		{
+			radiusSquared = distanceSquared;
+		}
+	}
+
+	sphere.radius = std::sqrt(radiusSquared);
+
+	return sphere;
+}
+}
@@ -0,0 +1,41 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../DllExport.hpp"
+#include "Math.hpp"
+
+namespace JuEngine
+{
+// Axis aligned box, it's empty (min > max) until a point or another box is added
+struct JUENGINEAPI BoundingBox
+{
+	vec3 min{1.f, 1.f, 1.f};
+	vec3 max{-1.f, -1.f, -1.f};
+
+	void Encapsulate(const vec3& point);
+	void Encapsulate(const BoundingBox& box);
+	auto IsEmpty() const -> bool;
+	auto GetCenter() const -> vec3;
+	auto GetExtents() const -> vec3;
+	auto GetSurfaceArea() const -> float;
+	auto Contains(const BoundingBox& box) const -> bool;
+	auto Intersects(const BoundingBox& box) const -> bool;
+	auto Intersects(const vec3& origin, const vec3& inverseDirection, const float maxDistance, float& distance) const -> bool;
+	auto Transform(const mat4& matrix) const -> BoundingBox;
+
+	static auto FromPoints(const float* points, const unsigned int count, const unsigned int stride) -> BoundingBox;
+};
+
+struct JUENGINEAPI BoundingSphere
+{
+	vec3 center{0.f, 0.f, 0.f};
+	float radius{0.f};
+
+	auto Intersects(const BoundingBox& box) const -> bool;
+
+	static auto FromPoints(const float* points, const unsigned int count, const unsigned int stride, const BoundingBox& box) -> BoundingSphere;
+};
+}
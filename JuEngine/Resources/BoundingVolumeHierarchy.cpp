@@ -0,0 +1,468 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <limits>
+
+namespace JuEngine
+{
+const int BoundingVolumeHierarchy::NullNode;
+
+BoundingVolumeHierarchy::BoundingVolumeHierarchy(const float margin) : mMargin(margin)
+{
+}
+
+auto BoundingVolumeHierarchy::Insert(const BoundingBox& box, const unsigned int userData) -> int
+{
+	if(box.IsEmpty())
+	{
+		ThrowRuntimeError("Error, an empty box can't be inserted in a bounding volume hierarchy");
+	}
+
+	int proxy = AllocateNode();
+	auto &node = mNodes[proxy];
+
+	node.box.min = box.min - vec3(mMargin);
+	node.box.max = box.max + vec3(mMargin);
+	node.userData = userData;
+	node.height = 0;
+
+	InsertLeaf(proxy);
+	++mLeafCount;
+
+	return proxy;
+}
+
+void BoundingVolumeHierarchy::Remove(const int proxy)
+{
+	RemoveLeaf(proxy);
+	FreeNode(proxy);
+	--mLeafCount;
+}
+
+// The leaf is only reinserted when the box leaves the enlarged box, returns if the tree changed
+auto BoundingVolumeHierarchy::Move(const int proxy, const BoundingBox& box) -> bool
+{
+	if(box.IsEmpty())
+	{
+		ThrowRuntimeError("Error, an empty box can't be inserted in a bounding volume hierarchy");
+	}
+
+	if(mNodes[proxy].box.Contains(box))
+	{
+		return false;
+	}
+
+	RemoveLeaf(proxy);
+
+	mNodes[proxy].box.min = box.min - vec3(mMargin);
+	mNodes[proxy].box.max = box.max + vec3(mMargin);
+
+	InsertLeaf(proxy);
+
+	return true;
+}
+
+void BoundingVolumeHierarchy::Clear()
+{
+	mNodes.clear();
+	mRoot = NullNode;
+	mFreeList = NullNode;
+	mLeafCount = 0;
+}
+
+auto BoundingVolumeHierarchy::GetUserData(const int proxy) const -> unsigned int
+{
+	return mNodes[proxy].userData;
+}
+
+auto BoundingVolumeHierarchy::GetFatBox(const int proxy) const -> const BoundingBox&
+{
+	return mNodes[proxy].box;
+}
+
+auto BoundingVolumeHierarchy::GetHeight() const -> int
+{
+	return (mRoot == NullNode ? 0 : mNodes[mRoot].height);
+}
+
+auto BoundingVolumeHierarchy::Count() const -> unsigned int
+{
+	return mLeafCount;
+}
+
+void BoundingVolumeHierarchy::Query(const BoundingBox& box, std::vector<int>& proxies) const
+{
+	mStack.clear();
+	mStack.push_back(mRoot);
+
+	while(! mStack.empty())
+	{
+		int node = mStack.back();
+		mStack.pop_back();
+
+		if(node == NullNode || ! mNodes[node].box.Intersects(box))
+		{
+			continue;
+		}
+
+		if(IsLeaf(node))
+		{
+			proxies.push_back(node);
+
+			continue;
+		}
+
+		mStack.push_back(mNodes[node].left);
+		mStack.push_back(mNodes[node].right);
+	}
+}
+
+void BoundingVolumeHierarchy::Query(const BoundingSphere& sphere, std::vector<int>& proxies) const
+{
+	mStack.clear();
+	mStack.push_back(mRoot);
+
+	while(! mStack.empty())
+	{
+		int node = mStack.back();
+		mStack.pop_back();
+
+		if(node == NullNode || ! sphere.Intersects(mNodes[node].box))
+		{
+			continue;
+		}
+
+		if(IsLeaf(node))
+		{
+			proxies.push_back(node);
+
+			continue;
+		}
+
+		mStack.push_back(mNodes[node].left);
+		mStack.push_back(mNodes[node].right);
+	}
+}
+
+// The subtrees completely inside the frustum are collected without testing their nodes
+void BoundingVolumeHierarchy::Query(const Frustum& frustum, std::vector<int>& proxies) const
+{
+	mStack.clear();
+	mStack.push_back(mRoot);
+
+	while(! mStack.empty())
+	{
+		int node = mStack.back();
+		mStack.pop_back();
+
+		if(node == NullNode || ! frustum.Intersects(mNodes[node].box))
+		{
+			continue;
+		}
+
+		if(IsLeaf(node))
+		{
+			proxies.push_back(node);
+
+			continue;
+		}
+
+		if(frustum.Contains(mNodes[node].box))
+		{
+			CollectLeaves(node, proxies);
+
+			continue;
+		}
+
+		mStack.push_back(mNodes[node].left);
+		mStack.push_back(mNodes[node].right);
+	}
+}
+
+void BoundingVolumeHierarchy::Raycast(const vec3& origin, const vec3& direction, const float maxDistance, std::vector<int>& proxies) const
+{
+	const float infinity = std::numeric_limits<float>::infinity();
+	vec3 inverseDirection;
+	float distance;
+
+	for(unsigned int axis = 0; axis < 3; ++axis)
+	{
+		inverseDirection[axis] = (direction[axis] != 0.f ? 1.f / direction[axis] : infinity);
+	}
+
+	mStack.clear();
+	mStack.push_back(mRoot);
+
+	while(! mStack.empty())
+	{
+		int node = mStack.back();
+		mStack.pop_back();
+
+		if(node == NullNode || ! mNodes[node].box.Intersects(origin, inverseDirection, maxDistance, distance))
+		{
+			continue;
+		}
+
+		if(IsLeaf(node))
+		{
+			proxies.push_back(node);
+
+			continue;
+		}
+
+		mStack.push_back(mNodes[node].left);
+		mStack.push_back(mNodes[node].right);
+	}
+}
+
+// The free nodes are linked through their parent index
+auto BoundingVolumeHierarchy::AllocateNode() -> int
+{
+	int node = mFreeList;
+
+	if(node == NullNode)
+	{
+		node = mNodes.size();
+		mNodes.push_back(Node());
+	}
+	else
+	{
+		mFreeList = mNodes[node].parent;
+	}
+
+	mNodes[node].box = BoundingBox();
+	mNodes[node].parent = NullNode;
+	mNodes[node].left = NullNode;
+	mNodes[node].right = NullNode;
+	mNodes[node].height = 0;
+	mNodes[node].userData = 0;
+
+	return node;
+}
+
+void BoundingVolumeHierarchy::FreeNode(const int node)
+{
+	mNodes[node].parent = mFreeList;
+	mNodes[node].height = -1;
+	mFreeList = node;
+}
+
+// Walks down to the sibling where the leaf increases the surface area of the tree the least
+void BoundingVolumeHierarchy::InsertLeaf(const int leaf)
+{
+	if(mRoot == NullNode)
+	{
+		mRoot = leaf;
+		mNodes[leaf].parent = NullNode;
+
+		return;
+	}
+
+	BoundingBox leafBox = mNodes[leaf].box;
+	int sibling = mRoot;
+
+	while(! IsLeaf(sibling))
+	{
+		auto &node = mNodes[sibling];
+		float area = node.box.GetSurfaceArea();
+		float combinedArea = Merge(node.box, leafBox).GetSurfaceArea();
+
+		// Cost of a new parent for this node and the leaf, and the minimum cost pushed to the children
+		float cost = 2.f * combinedArea;
+		float inheritanceCost = 2.f * (combinedArea - area);
+		float childCosts[2];
+		int children[2] = { node.left, node.right };
+
+		for(unsigned int i = 0; i < 2; ++i)
+		{
+			auto &child = mNodes[children[i]];
+			float childArea = Merge(leafBox, child.box).GetSurfaceArea();
+
+			childCosts[i] = (IsLeaf(children[i]) ? childArea : childArea - child.box.GetSurfaceArea()) + inheritanceCost;
+		}
+
+		if(cost < childCosts[0] && cost < childCosts[1])
+		{
+			break;
+		}
+
+		sibling = (childCosts[0] < childCosts[1] ? children[0] : children[1]);
+	}
+
+	int oldParent = mNodes[sibling].parent;
+	int newParent = AllocateNode();
+
+	mNodes[newParent].parent = oldParent;
+	mNodes[newParent].box = Merge(leafBox, mNodes[sibling].box);
+	mNodes[newParent].height = mNodes[sibling].height + 1;
+	mNodes[newParent].left = sibling;
+	mNodes[newParent].right = leaf;
+	mNodes[sibling].parent = newParent;
+	mNodes[leaf].parent = newParent;
+
+	if(oldParent == NullNode)
+	{
+		mRoot = newParent;
+	}
+	else if(mNodes[oldParent].left == sibling)
+	{
+		mNodes[oldParent].left = newParent;
+	}
+	else
+	{
+		mNodes[oldParent].right = newParent;
+	}
+
+	Refit(mNodes[leaf].parent);
+}
+
+void BoundingVolumeHierarchy::RemoveLeaf(const int leaf)
+{
+	if(leaf == mRoot)
+	{
+		mRoot = NullNode;
+
+		return;
+	}
+
+	int parent = mNodes[leaf].parent;
+	int grandParent = mNodes[parent].parent;
+	int sibling = (mNodes[parent].left == leaf ? mNodes[parent].right : mNodes[parent].left);
+
+	mNodes[sibling].parent = grandParent;
+	FreeNode(parent);
+
+	if(grandParent == NullNode)
+	{
+		mRoot = sibling;
+
+		return;
+	}
+
+	if(mNodes[grandParent].left == parent)
+	{
+		mNodes[grandParent].left = sibling;
+	}
+	else
+	{
+		mNodes[grandParent].right = sibling;
+	}
+
+	Refit(grandParent);
+}
+
+// Balances and recalculates the boxes and heights from the node to the root
+void BoundingVolumeHierarchy::Refit(int node)
+{
+	while(node != NullNode)
+	{
+		node = Balance(node);
+
+		auto &current = mNodes[node];
+		auto &left = mNodes[current.left];
+		auto &right = mNodes[current.right];
+
+		current.height = 1 + std::max(left.height, right.height);
+		current.box = Merge(left.box, right.box);
+
+		node = current.parent;
+	}
+}
+
+// Rotates the taller child up when the heights of the children differ by more than one,
+// returns the node that takes the place of the given one
+auto BoundingVolumeHierarchy::Balance(const int a) -> int
+{
+	if(IsLeaf(a) || mNodes[a].height < 2)
+	{
+		return a;
+	}
+
+	int b = mNodes[a].left;
+	int c = mNodes[a].right;
+	int balance = mNodes[c].height - mNodes[b].height;
+
+	if(balance >= -1 && balance <= 1)
+	{
+		return a;
+	}
+
+	// The taller child (up) replaces A, A keeps the shorter child (other) and one of the
+	// children of up, the taller grandchild stays in up
+	bool rotateRight = (balance > 1);
+	int up = (rotateRight ? c : b);
+	int other = (rotateRight ? b : c);
+	int f = mNodes[up].left;
+	int g = mNodes[up].right;
+
+	mNodes[up].left = a;
+	mNodes[up].parent = mNodes[a].parent;
+	mNodes[a].parent = up;
+
+	if(mNodes[up].parent == NullNode)
+	{
+		mRoot = up;
+	}
+	else if(mNodes[mNodes[up].parent].left == a)
+	{
+		mNodes[mNodes[up].parent].left = up;
+	}
+	else
+	{
+		mNodes[mNodes[up].parent].right = up;
+	}
+
+	int taller = (mNodes[f].height > mNodes[g].height ? f : g);
+	int shorter = (taller == f ? g : f);
+
+	mNodes[up].right = taller;
+
+	if(rotateRight)
+	{
+		mNodes[a].right = shorter;
+	}
+	else
+	{
+		mNodes[a].left = shorter;
+	}
+
+	mNodes[shorter].parent = a;
+
+	mNodes[a].box = Merge(mNodes[other].box, mNodes[shorter].box);
+	mNodes[a].height = 1 + std::max(mNodes[other].height, mNodes[shorter].height);
+	mNodes[up].box = Merge(mNodes[a].box, mNodes[taller].box);
+	mNodes[up].height = 1 + std::max(mNodes[a].height, mNodes[taller].height);
+
+	return up;
+}
+
+void BoundingVolumeHierarchy::CollectLeaves(const int node, std::vector<int>& proxies) const
+{
+	if(IsLeaf(node))
+	{
+		proxies.push_back(node);
+
+		return;
+	}
+
+	CollectLeaves(mNodes[node].left, proxies);
+	CollectLeaves(mNodes[node].right, proxies);
+}
+
+auto BoundingVolumeHierarchy::IsLeaf(const int node) const -> bool
+{
+	return (mNodes[node].left == NullNode);
+}
+
+auto BoundingVolumeHierarchy::Merge(const BoundingBox& a, const BoundingBox& b) -> BoundingBox
+{
+	BoundingBox box = a;
+	box.Encapsulate(b);
+
+	return box;
+}
+}
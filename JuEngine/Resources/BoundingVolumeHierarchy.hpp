@@ -0,0 +1,66 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Frustum.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+// Dynamic AABB tree, every leaf (proxy) stores an enlarged box so the objects can move a little
+// without changing the tree. Inserts pick the sibling with the lowest surface area cost and the
+// tree is kept balanced with rotations, so queries visit O(log n) nodes.
+class JUENGINEAPI BoundingVolumeHierarchy
+{
+	public:
+		BoundingVolumeHierarchy(const float margin = 0.1f);
+
+		auto Insert(const BoundingBox& box, const unsigned int userData) -> int;
+		void Remove(const int proxy);
+		auto Move(const int proxy, const BoundingBox& box) -> bool;
+		void Clear();
+
+		auto GetUserData(const int proxy) const -> unsigned int;
+		auto GetFatBox(const int proxy) const -> const BoundingBox&;
+		auto GetHeight() const -> int;
+		auto Count() const -> unsigned int;
+
+		// The proxies whose enlarged boxes pass the test are appended to the list
+		void Query(const BoundingBox& box, std::vector<int>& proxies) const;
+		void Query(const BoundingSphere& sphere, std::vector<int>& proxies) const;
+		void Query(const Frustum& frustum, std::vector<int>& proxies) const;
+		void Raycast(const vec3& origin, const vec3& direction, const float maxDistance, std::vector<int>& proxies) const;
+
+		static const int NullNode = -1;
+
+	private:
+		struct Node
+		{
+			BoundingBox box;
+			int parent;
+			int left;
+			int right;
+			int height;
+			unsigned int userData;
+		};
+
+		auto AllocateNode() -> int;
+		void FreeNode(const int node);
+		void InsertLeaf(const int leaf);
+		void RemoveLeaf(const int leaf);
+		void Refit(int node);
+		auto Balance(const int node) -> int;
+		void CollectLeaves(const int node, std::vector<int>& proxies) const;
+		auto IsLeaf(const int node) const -> bool;
+		static auto Merge(const BoundingBox& a, const BoundingBox& b) -> BoundingBox;
+
+		std::vector<Node> mNodes;
+		int mRoot{NullNode};
+		int mFreeList{NullNode};
+		unsigned int mLeafCount{0};
+		float mMargin;
+		mutable std::vector<int> mStack;
+};
+}
@@ -9,62 +9,250 @@
 
 #include "../DllExport.hpp"
 #include <mutex>
-#include <list>
 #include <vector>
 #include <memory>
+#include <functional>
+#include <typeinfo>
+#include <type_traits>
+#include <cstddef>
 
 namespace JuEngine
 {
-template<typename>
+typedef unsigned int DelegateHandle;
+
+struct JUENGINEAPI DelegateMutexLock
+{
+	public:
+		inline void Lock() { mMutex.lock(); }
+		inline void Unlock() { mMutex.unlock(); }
+
+	private:
+		std::mutex mMutex;
+};
+
+// For delegates that are only used from one thread (like the entity system events)
+struct JUENGINEAPI DelegateNoLock
+{
+	public:
+		inline void Lock() {}
+		inline void Unlock() {}
+};
+
+template<typename, typename TLockPolicy = DelegateMutexLock>
 class Delegate;
 
 namespace DelegateImpl
 {
+template <typename TLockPolicy>
+struct LockGuard
+{
+	public:
+		LockGuard(TLockPolicy& policy) : mPolicy(policy) { mPolicy.Lock(); }
+		~LockGuard() { mPolicy.Unlock(); }
+
+	private:
+		TLockPolicy& mPolicy;
+};
+
+template <typename TFunction, typename TReturnType, typename... TArgs>
+struct InlineStorage
+{
+	static void Create(void* buffer, TFunction&& function)
+	{
+		new (buffer) TFunction(std::move(function));
+	}
+
+	static TReturnType Invoke(void* buffer, TArgs... args)
+	{
+		return (*static_cast<TFunction*>(buffer))(args...);
+	}
+
+	static void Move(void* source, void* destination)
+	{
+		new (destination) TFunction(std::move(*static_cast<TFunction*>(source)));
+		static_cast<TFunction*>(source)->~TFunction();
+	}
+
+	static void Destroy(void* buffer)
+	{
+		static_cast<TFunction*>(buffer)->~TFunction();
+	}
+};
+
+template <typename TFunction, typename TReturnType, typename... TArgs>
+struct HeapStorage
+{
+	static void Create(void* buffer, TFunction&& function)
+	{
+		*static_cast<TFunction**>(buffer) = new TFunction(std::move(function));
+	}
+
+	static TReturnType Invoke(void* buffer, TArgs... args)
+	{
+		return (**static_cast<TFunction**>(buffer))(args...);
+	}
+
+	static void Move(void* source, void* destination)
+	{
+		*static_cast<TFunction**>(destination) = *static_cast<TFunction**>(source);
+	}
+
+	static void Destroy(void* buffer)
+	{
+		delete *static_cast<TFunction**>(buffer);
+	}
+};
+
+// Type-erased callable, stored inside the object when it fits (no allocation)
 template <typename TReturnType, typename... TArgs>
+class Callable
+{
+	public:
+		static const std::size_t BufferSize = 4 * sizeof(void*);
+
+		template <typename TFunction>
+		explicit Callable(TFunction function)
+		{
+			typedef typename std::conditional<(sizeof(TFunction) <= BufferSize && alignof(TFunction) <= alignof(std::max_align_t) &&
+				std::is_nothrow_move_constructible<TFunction>::value),
+				InlineStorage<TFunction, TReturnType, TArgs...>, HeapStorage<TFunction, TReturnType, TArgs...>>::type Storage;
+
+			Storage::Create(&mBuffer, std::move(function));
+			mInvoke = &Storage::Invoke;
+			mMove = &Storage::Move;
+			mDestroy = &Storage::Destroy;
+		}
+
+		Callable(Callable&& other) : mInvoke(other.mInvoke), mMove(other.mMove), mDestroy(other.mDestroy)
+		{
+			mMove(&other.mBuffer, &mBuffer);
+			other.mDestroy = nullptr;
+		}
+
+		Callable& operator =(Callable&& other)
+		{
+			if(this != &other)
+			{
+				Reset();
+				mInvoke = other.mInvoke;
+				mMove = other.mMove;
+				mDestroy = other.mDestroy;
+				mMove(&other.mBuffer, &mBuffer);
+				other.mDestroy = nullptr;
+			}
+
+			return *this;
+		}
+
+		Callable(const Callable&) = delete;
+		Callable& operator =(const Callable&) = delete;
+
+		~Callable()
+		{
+			Reset();
+		}
+
+		inline TReturnType operator ()(TArgs... args)
+		{
+			return mInvoke(&mBuffer, args...);
+		}
+
+	private:
+		void Reset()
+		{
+			if(mDestroy != nullptr)
+			{
+				mDestroy(&mBuffer);
+				mDestroy = nullptr;
+			}
+		}
+
+		typename std::aligned_storage<BufferSize, alignof(std::max_align_t)>::type mBuffer;
+		TReturnType (*mInvoke)(void* buffer, TArgs... args);
+		void (*mMove)(void* source, void* destination);
+		void (*mDestroy)(void* buffer);
+};
+
+template <typename TFunction>
+std::size_t TypeHash(const TFunction&)
+{
+	return typeid(TFunction).hash_code();
+}
+
+template <typename TSignature>
+std::size_t TypeHash(const std::function<TSignature>& function)
+{
+	return function.target_type().hash_code();
+}
+
+// Handlers connected or disconnected while invoking are applied when the invocation ends
+template <typename TDelegate>
+struct InvokeScope
+{
+	public:
+		InvokeScope(TDelegate& delegate) : mDelegate(delegate) { ++mDelegate.mInvoking; }
+		~InvokeScope() { if(--mDelegate.mInvoking == 0) { mDelegate.Flush(); } }
+
+	private:
+		TDelegate& mDelegate;
+};
+
+template <typename TLockPolicy, typename TReturnType, typename... TArgs>
 struct JUENGINEAPI Invoker
 {
 	using ReturnType = std::vector<TReturnType>;
 
 	public:
-		static ReturnType Invoke(Delegate<TReturnType(TArgs...)> &delegate, TArgs... params)
+		static ReturnType Invoke(Delegate<TReturnType(TArgs...), TLockPolicy> &delegate, TArgs... params)
 		{
-			std::lock_guard<std::mutex> lock(delegate.mMutex);
+			LockGuard<TLockPolicy> lock(delegate.mLock);
+			InvokeScope<Delegate<TReturnType(TArgs...), TLockPolicy>> scope(delegate);
 			ReturnType returnValues;
 
-			for (const auto &functionPtr : delegate.mFunctionList)
+			for (unsigned int i = 0, count = delegate.mSlots.size(); i < count; ++i)
 			{
-				returnValues.push_back((*functionPtr)(params...));
+				if(delegate.mSlots[i].handle != 0)
+				{
+					returnValues.push_back(delegate.mSlots[i].callable(params...));
+				}
 			}
 
 			return returnValues;
 		}
 };
 
-template <typename... TArgs>
-struct JUENGINEAPI Invoker<void, TArgs...>
+template <typename TLockPolicy, typename... TArgs>
+struct JUENGINEAPI Invoker<TLockPolicy, void, TArgs...>
 {
 	using ReturnType = void;
 
 	public:
-		static void Invoke(Delegate<void(TArgs...)> &delegate, TArgs... params)
+		static void Invoke(Delegate<void(TArgs...), TLockPolicy> &delegate, TArgs... params)
 		{
-			std::lock_guard<std::mutex> lock(delegate.mMutex);
+			LockGuard<TLockPolicy> lock(delegate.mLock);
+			InvokeScope<Delegate<void(TArgs...), TLockPolicy>> scope(delegate);
 
-			for (const auto &functionPtr : delegate.mFunctionList)
+			for (unsigned int i = 0, count = delegate.mSlots.size(); i < count; ++i)
 			{
-				(*functionPtr)(params...);
+				if(delegate.mSlots[i].handle != 0)
+				{
+					delegate.mSlots[i].callable(params...);
+				}
 			}
 		}
 };
 }
 
-template<typename TReturnType, typename... TArgs>
-class JUENGINEAPI Delegate<TReturnType(TArgs...)>
+template<typename TReturnType, typename... TArgs, typename TLockPolicy>
+class JUENGINEAPI Delegate<TReturnType(TArgs...), TLockPolicy>
 {
-	using Invoker = DelegateImpl::Invoker<TReturnType, TArgs...>;
+	using Invoker = DelegateImpl::Invoker<TLockPolicy, TReturnType, TArgs...>;
+	using InvokeScope = DelegateImpl::InvokeScope<Delegate>;
+	using Callable = DelegateImpl::Callable<TReturnType, TArgs...>;
 	using functionType = std::function<TReturnType(TArgs...)>;
 
 	friend Invoker;
+	friend InvokeScope;
 
 	public:
 		Delegate() {}
@@ -73,22 +261,56 @@ class JUENGINEAPI Delegate<TReturnType(TArgs...)>
 		Delegate(const Delegate&) = delete;
 		const Delegate& operator =(const Delegate&) = delete;
 
-		Delegate& Connect(const functionType &function)
+		template <typename TFunction>
+		Delegate& Connect(TFunction function)
+		{
+			Subscribe(std::move(function));
+
+			return *this;
+		}
+
+		// Returns a handle that disconnects exactly this handler with Unsubscribe
+		template <typename TFunction>
+		DelegateHandle Subscribe(TFunction function)
+		{
+			DelegateImpl::LockGuard<TLockPolicy> lock(this->mLock);
+
+			auto handle = this->mNextHandle++;
+			auto typeHash = DelegateImpl::TypeHash(function);
+			auto &slots = (this->mInvoking > 0 ? this->mPendingSlots : this->mSlots);
+
+			slots.push_back(Slot(handle, typeHash, Callable(std::move(function))));
+
+			if(this->mNextHandle == 0)
+			{
+				this->mNextHandle = 1;
+			}
+
+			return handle;
+		}
+
+		Delegate& Unsubscribe(const DelegateHandle handle)
 		{
-			std::lock_guard<std::mutex> lock(this->mMutex);
+			DelegateImpl::LockGuard<TLockPolicy> lock(this->mLock);
 
-			this->mFunctionList.push_back(std::make_shared<functionType>(function));
+			Disconnect([&](const Slot &slot)
+			{
+				return slot.handle == handle;
+			});
 
 			return *this;
 		}
 
+		// Removes every handler of the same callable type
 		Delegate& Remove(const functionType &function)
 		{
-			std::lock_guard<std::mutex> lock(this->mMutex);
+			DelegateImpl::LockGuard<TLockPolicy> lock(this->mLock);
 
-			this->mFunctionList.remove_if([&](std::shared_ptr<functionType> &functionPtr)
+			auto typeHash = DelegateImpl::TypeHash(function);
+
+			Disconnect([&](const Slot &slot)
 			{
-				return Hash(function) == Hash(*functionPtr);
+				return slot.typeHash == typeHash;
 			});
 
 			return *this;
@@ -101,16 +323,35 @@ class JUENGINEAPI Delegate<TReturnType(TArgs...)>
 
 		Delegate& Clear()
 		{
-			std::lock_guard<std::mutex> lock(this->mMutex);
+			DelegateImpl::LockGuard<TLockPolicy> lock(this->mLock);
 
-			this->mFunctionList.clear();
+			Disconnect([](const Slot &)
+			{
+				return true;
+			});
 
 			return *this;
 		}
 
-		inline Delegate& operator +=(const functionType &function)
+		bool IsEmpty()
 		{
-			return Connect(function);
+			DelegateImpl::LockGuard<TLockPolicy> lock(this->mLock);
+
+			for(const auto &slot : this->mSlots)
+			{
+				if(slot.handle != 0)
+				{
+					return false;
+				}
+			}
+
+			return this->mPendingSlots.empty();
+		}
+
+		template <typename TFunction>
+		inline Delegate& operator +=(TFunction function)
+		{
+			return Connect(std::move(function));
 		}
 
 		inline Delegate& operator -=(const functionType &function)
@@ -118,18 +359,87 @@ class JUENGINEAPI Delegate<TReturnType(TArgs...)>
 			return Remove(function);
 		}
 
+		inline Delegate& operator -=(const DelegateHandle handle)
+		{
+			return Unsubscribe(handle);
+		}
+
 		inline typename Invoker::ReturnType operator ()(TArgs... args)
 		{
 			return Invoker::Invoke(*this, args...);
 		}
 
 	private:
-		std::mutex mMutex;
-		std::list<std::shared_ptr<functionType>> mFunctionList;
+		struct Slot
+		{
+			Slot(const DelegateHandle handle, const std::size_t typeHash, Callable&& callable) :
+				handle(handle), typeHash(typeHash), callable(std::move(callable)) {}
+
+			DelegateHandle handle;
+			std::size_t typeHash;
+			Callable callable;
+		};
 
-		inline constexpr size_t Hash(const functionType &function) const
+		template <typename TPredicate>
+		void Disconnect(TPredicate predicate)
 		{
-			return function.target_type().hash_code();
+			for(auto &slot : this->mSlots)
+			{
+				if(slot.handle != 0 && predicate(slot))
+				{
+					slot.handle = 0;
+				}
+			}
+
+			for(auto &slot : this->mPendingSlots)
+			{
+				if(predicate(slot))
+				{
+					slot.handle = 0;
+				}
+			}
+
+			// A handler that is being invoked cannot be destroyed yet
+			if(this->mInvoking == 0)
+			{
+				Flush();
+			}
 		}
+
+		void Flush()
+		{
+			unsigned int count = 0;
+
+			for(unsigned int i = 0, slotCount = this->mSlots.size(); i < slotCount; ++i)
+			{
+				if(this->mSlots[i].handle != 0)
+				{
+					if(i != count)
+					{
+						this->mSlots[count] = std::move(this->mSlots[i]);
+					}
+
+					++count;
+				}
+			}
+
+			this->mSlots.erase(this->mSlots.begin() + count, this->mSlots.end());
+
+			for(auto &slot : this->mPendingSlots)
+			{
+				if(slot.handle != 0)
+				{
+					this->mSlots.push_back(std::move(slot));
+				}
+			}
+
+			this->mPendingSlots.clear();
+		}
+
+		TLockPolicy mLock;
+		std::vector<Slot> mSlots;
+		std::vector<Slot> mPendingSlots;
+		DelegateHandle mNextHandle{1};
+		unsigned int mInvoking{0};
 };
 }
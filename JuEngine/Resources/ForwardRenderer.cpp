@@ -55,38 +55,40 @@ ForwardRenderer::ForwardRenderer()
 
 	// ----------------
 
-	/*glGenBuffers(1, &mWorldUBO);
+	glGenBuffers(1, &mWorldUBO);
 	glBindBuffer(GL_UNIFORM_BUFFER, mWorldUBO);
-	glBufferData(GL_UNIFORM_BUFFER, sizeof(vec4) + sizeof(float) * 3, NULL, GL_DYNAMIC_DRAW);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(WorldBlock), NULL, GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, mWorldBindingIndex, mWorldUBO, 0, sizeof(vec4) + sizeof(float) * 3);*/
+	glBindBufferRange(GL_UNIFORM_BUFFER, mWorldBindingIndex, mWorldUBO, 0, sizeof(WorldBlock));
 
 	// ----------------
 
-	/*glGenBuffers(1, &mMaterialUBO);
+	glGenBuffers(1, &mMaterialUBO);
 	glBindBuffer(GL_UNIFORM_BUFFER, mMaterialUBO);
-	glBufferData(GL_UNIFORM_BUFFER, sizeof(vec4) * 2 + sizeof(float), NULL, GL_DYNAMIC_DRAW);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(GLRenderBackend::MaterialBlock), NULL, GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, mMaterialBindingIndex, mMaterialUBO, 0, sizeof(vec4) * 2 + sizeof(float));*/
+	glBindBufferRange(GL_UNIFORM_BUFFER, mMaterialBindingIndex, mMaterialUBO, 0, sizeof(GLRenderBackend::MaterialBlock));
+
+	mBackend.SetMaterialBuffer(mMaterialUBO);
 
 	// ----------------
 
-	/*glGenBuffers(1, &mLightUBO);
+	glGenBuffers(1, &mLightUBO);
 	glBindBuffer(GL_UNIFORM_BUFFER, mLightUBO);
-	glBufferData(GL_UNIFORM_BUFFER, sizeof(vec4) * 2 * 5, NULL, GL_DYNAMIC_DRAW);
+	glBufferData(GL_UNIFORM_BUFFER, sizeof(LightBlock), NULL, GL_DYNAMIC_DRAW);
 	glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-	glBindBufferRange(GL_UNIFORM_BUFFER, mLightBindingIndex, mLightUBO, 0, sizeof(vec4) * 2 * 5);*/
+	glBindBufferRange(GL_UNIFORM_BUFFER, mLightBindingIndex, mLightUBO, 0, sizeof(LightBlock));
 }
 
 ForwardRenderer::~ForwardRenderer()
 {
 	glDeleteBuffers(1, &mGlobalMatrixUBO);
-	//glDeleteBuffers(1, &mWorldUBO);
-	//glDeleteBuffers(1, &mMaterialUBO);
-	//glDeleteBuffers(1, &mLightUBO);
+	glDeleteBuffers(1, &mWorldUBO);
+	glDeleteBuffers(1, &mMaterialUBO);
+	glDeleteBuffers(1, &mLightUBO);
 }
 
 void ForwardRenderer::Render()
@@ -96,42 +98,83 @@ void ForwardRenderer::Render()
 		return;
 	}
 
-	// TODO: ForwardRenderer: Cache entities
-	std::stringstream ss;
-	std::vector<EntityPtr> cameras;
-	std::vector<EntityPtr> entities;
-	std::vector<EntityPtr> lights;
 	World* world = nullptr;
 
-	for(const auto &pool : mPools)
+	UpdatePoolGroups();
+
+	for(auto &groups : mPoolGroups)
 	{
-		auto poolCameras = pool->GetGroup(Matcher_AllOf(Transform, Camera))->GetEntities();
-		auto poolEntities = pool->GetGroup(Matcher_AllOf(Transform, MeshRenderer))->GetEntities();
-		auto poolLights = pool->GetGroup(Matcher_AllOf(Transform, Light))->GetEntities();
+		if(groups.hierarchy)
+		{
+			groups.hierarchy->Update();
+		}
 
-		cameras.insert(cameras.end(), poolCameras.begin(), poolCameras.end());
-		entities.insert(entities.end(), poolEntities.begin(), poolEntities.end());
-		lights.insert(lights.end(), poolLights.begin(), poolLights.end());
+		auto &poolCameras = groups.cameras->GetEntityList();
+		auto &poolEntities = groups.entities->GetEntityList();
+		auto &poolLights = groups.lights->GetEntityList();
+
+		if(! groups.hierarchy)
+		{
+			CheckTransformParents(poolCameras);
+			CheckTransformParents(poolEntities);
+			CheckTransformParents(poolLights);
+		}
+
+		mCameras.insert(mCameras.end(), poolCameras.begin(), poolCameras.end());
+		mEntities.insert(mEntities.end(), poolEntities.begin(), poolEntities.end());
+		mLights.insert(mLights.end(), poolLights.begin(), poolLights.end());
+
+		for(const auto &entity : poolEntities)
+		{
+			if(groups.hierarchy)
+			{
+				mEntityMatrices.push_back(&groups.hierarchy->GetWorldMatrix(entity));
+				mEntityNormalMatrices.push_back(groups.hierarchy->GetNormalMatrix(entity));
+			}
+			else
+			{
+				mEntityMatrices.push_back(&entity->Get<Transform>()->GetMatrix());
+				mEntityNormalMatrices.push_back(mat3(1.f));
+				TransformBatch::CalculateNormalMatrices(mEntityMatrices.back(), &mEntityNormalMatrices.back(), 1);
+			}
+		}
 	}
 
-	for(const auto &pool : mPools)
+	// World space boxes of the entities, they are tested against the frustum of each camera
+	mCuller.Clear();
+	mCuller.Reserve(mEntities.size());
+
+	for(unsigned int i = 0, count = mEntities.size(); i < count; ++i)
+	{
+		auto meshNode = mEntities[i]->Get<MeshRenderer>()->GetMeshNode();
+
+		mCuller.Add(meshNode->GetBoundingBox().Transform(*mEntityMatrices[i]));
+	}
+
+	mEntityVisibility.resize(mEntities.size());
+
+	for(auto &groups : mPoolGroups)
 	{
-		if(pool->GetGroup(Matcher_AllOf(World))->Count() == 0)
+		if(groups.worlds->Count() == 0)
 		{
 			continue;
 		}
 
-		world = pool->GetGroup(Matcher_AllOf(World))->GetSingleEntity()->Get<World>();
+		world = groups.worlds->GetSingleEntity()->Get<World>();
 
 		float gammaCorrection = 1.f / world->GetGammaCorrection();
 
 		// Actualizamos el Uniform Block "World"
-		/*glBindBuffer(GL_UNIFORM_BUFFER, mWorldUBO);
-		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(vec3), Math::GetDataPtr(world->GetAmbientColor()));
-		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(vec4), sizeof(float), &world->GetAmbientIntensity());
-		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(vec4) + sizeof(float), sizeof(float), &world->GetLightAttenuation());
-		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(vec4) + sizeof(float) * 2, sizeof(float), &gammaCorrection);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);*/
+		WorldBlock worldBlock = {
+			vec4(world->GetAmbientColor(), 1.f),
+			world->GetAmbientIntensity(),
+			world->GetLightAttenuation(),
+			gammaCorrection,
+			0.f
+		};
+		glBindBuffer(GL_UNIFORM_BUFFER, mWorldUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(WorldBlock), &worldBlock);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
 		// Actualizamos el valor que usará la limpieza de buffer de color
 		auto skyColor = world->GetSkyColor();
@@ -148,7 +191,7 @@ void ForwardRenderer::Render()
 	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
 	// Dibujamos la escena por cada cámara activa
-	for(const auto &cameraEntity : cameras)
+	for(const auto &cameraEntity : mCameras)
 	{
 		// Actualizamos el viewport dependiendo de la cámara y el tamaño de la pantalla
 		auto camera = cameraEntity->Get<Camera>();
@@ -168,168 +211,255 @@ void ForwardRenderer::Render()
 		glBufferSubData(GL_UNIFORM_BUFFER, sizeof(mat4), sizeof(mat4), Math::GetDataPtr(camera->GetViewMatrix()));
 		glBindBuffer(GL_UNIFORM_BUFFER, 0);
 
-		// Actualizamos el Uniform Block "Light"
-		/*unsigned int lightCounter = 0;
-		struct PerLight { vec4 lightPosType; vec4 lightIntensity; } lightsStruct[5];
-		Light* light = nullptr;
-		for(const auto &lightEntity : lights)
-		{
-			light = lightEntity->Get<Light>();
+		// Update the "Light" uniform block, once per camera
+		auto cameraTransform = cameraEntity->Get<Transform>();
+		PackLights(cameraTransform, mLights);
+		glBindBuffer(GL_UNIFORM_BUFFER, mLightUBO);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LightBlock), &mLightBlock);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+		// Queue a draw command per mesh, sorted to minimize the state changes
+		vec3 cameraPosition = cameraTransform->GetPosition();
 
-			lightsStruct[lightCounter].lightPosType = vec4(
-				cameraEntity->Get<Transform>()->InverseTransformPoint(lightEntity->Get<Transform>()->GetPosition()),
-				light->GetType() == LightType::LIGHT_POINT ? 1.f : 0.f
-			);
-			lightsStruct[lightCounter].lightIntensity = vec4((light->GetColor() * light->GetIntensity()), 1.f);
+		mCuller.Cull(Frustum(camera->GetPerspectiveMatrix() * camera->GetViewMatrix()), mEntityVisibility.data());
+		mRenderQueue.Clear();
 
-			if(++lightCounter == 5)
+		for(unsigned int i = 0, count = mEntities.size(); i < count; ++i)
+		{
+			if(! mEntityVisibility[i])
 			{
-				break;
+				continue;
 			}
+
+			MeshRenderer* meshRenderer = mEntities[i]->Get<MeshRenderer>();
+			float depth = glm::length(vec3((*mEntityMatrices[i])[3]) - cameraPosition);
+
+			QueueMeshNode(meshRenderer->GetMeshNode(), meshRenderer->GetShader(), mEntityMatrices[i], &mEntityNormalMatrices[i], depth);
 		}
-		glBindBuffer(GL_UNIFORM_BUFFER, mLightUBO);
-		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(vec4) * 2 * 5, &lightsStruct);
-		glBindBuffer(GL_UNIFORM_BUFFER, 0);*/
 
-		// Renderizamos todas las entidades con un meshRenderer
-		for(const auto &entity : entities)
+		mRenderQueue.Sort();
+		mRenderQueue.Submit(&mBackend, [&](Shader* shader)
 		{
-			MeshRenderer* meshRenderer = entity->Get<MeshRenderer>();
-			Shader* shader = meshRenderer->GetShader();
-			MeshNode* rootMeshNode = meshRenderer->GetMeshNode();
+			SetShaderUniforms(shader, cameraTransform, world);
+		});
+	}
+
+	ClearFrameEntities();
+}
 
-			if(shader != nullptr)
+// The lights are packed once per camera, in view space, for the "Light" uniform block
+void ForwardRenderer::PackLights(Transform* cameraTransform, const std::vector<EntityPtr>& lights)
+{
+	unsigned int lightDirCounter = 0;
+	unsigned int lightPointCounter = 0;
+	unsigned int lightSpotCounter = 0;
+	Light* light = nullptr;
+
+	for(const auto &lightEntity : lights)
+	{
+		light = lightEntity->Get<Light>();
+		auto lightTransform = lightEntity->Get<Transform>();
+		vec4 color = vec4(light->GetColor() * light->GetIntensity(), 1.f);
+
+		if(light->GetType() == LightType::LIGHT_DIRECTIONAL)
+		{
+			if(lightDirCounter >= MaxDirLights)
 			{
-				shader->Use();
-
-				shader->SetUniform("modelToWorldMatrix", entity->Get<Transform>()->GetMatrix());
-
-				// TEMP (World):
-				if(world)
-				{
-					shader->SetUniform("world.ambient", world->GetAmbientColor() * world->GetAmbientIntensity());
-				}
-
-				// TEMP (Others):
-				shader->SetUniform("normalMatrix", mat3(glm::transpose(glm::inverse(entity->Get<Transform>()->GetMatrix()))));
-				shader->SetUniform("cameraPosition", cameraEntity->Get<Transform>()->GetPosition());
-				//shader->SetUniform("lightPosition", vec3(lights[0]->Get<Transform>()->GetPosition())); // Gouraud Shading
-
-				// TEMP (Lights):
-				unsigned int lightDirCounter = 0;
-				unsigned int lightPointCounter = 0;
-				unsigned int lightSpotCounter = 0;
-				unsigned int maxLightDir = 2;
-				unsigned int maxLightPoint = 5;
-				unsigned int maxLightSpot = 1;
-				Light* light = nullptr;
-				for(const auto &lightEntity : lights)
-				{
-					light = lightEntity->Get<Light>();
-
-					if(light->GetType() == LightType::LIGHT_DIRECTIONAL)
-					{
-						if(lightDirCounter >= maxLightDir)
-						{
-							continue;
-						}
-
-						ss.str(std::string());
-						ss << "dirLights[" << lightDirCounter << "].";
-						shader->SetUniform(ss.str() + "direction", cameraEntity->Get<Transform>()->InverseTransformDirection(lightEntity->Get<Transform>()->Forward()));
-						shader->SetUniform(ss.str() + "color", light->GetColor() * light->GetIntensity());
-
-						++lightDirCounter;
-					}
-					else if(light->GetType() == LightType::LIGHT_POINT)
-					{
-						if(lightPointCounter >= maxLightPoint)
-						{
-							continue;
-						}
-
-						ss.str(std::string());
-						ss << "pointLights[" << lightPointCounter << "].";
-						shader->SetUniform(ss.str() + "position", cameraEntity->Get<Transform>()->InverseTransformPoint(lightEntity->Get<Transform>()->GetPosition()));
-						shader->SetUniform(ss.str() + "color", light->GetColor() * light->GetIntensity());
-						shader->SetUniform(ss.str() + "constant", 1.0f);
-						shader->SetUniform(ss.str() + "linear", light->GetLinearAttenuation());
-						shader->SetUniform(ss.str() + "quadratic", light->GetQuadraticAttenuation());
-
-						++lightPointCounter;
-					}
-					else if(light->GetType() == LightType::LIGHT_SPOT)
-					{
-						if(lightSpotCounter >= maxLightSpot)
-						{
-							continue;
-						}
-
-						ss.str(std::string());
-						ss << "spotLights[" << lightSpotCounter << "].";
-						shader->SetUniform(ss.str() + "position", cameraEntity->Get<Transform>()->InverseTransformPoint(lightEntity->Get<Transform>()->GetPosition()));
-						shader->SetUniform(ss.str() + "color", light->GetColor() * light->GetIntensity());
-						shader->SetUniform(ss.str() + "constant", 1.0f);
-						shader->SetUniform(ss.str() + "linear", light->GetLinearAttenuation());
-						shader->SetUniform(ss.str() + "quadratic", light->GetQuadraticAttenuation());
-						shader->SetUniform(ss.str() + "direction", cameraEntity->Get<Transform>()->InverseTransformDirection(lightEntity->Get<Transform>()->Forward()));
-						shader->SetUniform(ss.str() + "cutOff", light->GetSpotCutOff());
-						shader->SetUniform(ss.str() + "outerCutOff", light->GetSpotOuterCutOff());
-
-						++lightSpotCounter;
-					}
-				}
-
-				// Set to zero all remaining light uniforms
-				for(unsigned int i = lightDirCounter; i < maxLightDir; ++i)
-				{
-					ss.str(std::string());
-					ss << "dirLights[" << i << "].";
-					shader->SetUniform(ss.str() + "direction", vec3(0.f, 0.f, 1.f));
-					shader->SetUniform(ss.str() + "color", vec3(0.f, 0.f, 0.f));
-				}
-				for(unsigned int i = lightPointCounter; i < maxLightPoint; ++i)
-				{
-					ss.str(std::string());
-					ss << "pointLights[" << i << "].";
-					shader->SetUniform(ss.str() + "position", vec3(0.f, 0.f, 0.f));
-					shader->SetUniform(ss.str() + "color", vec3(0.f, 0.f, 0.f));
-					shader->SetUniform(ss.str() + "constant", 1.0f);
-					shader->SetUniform(ss.str() + "linear", 0.09f);
-					shader->SetUniform(ss.str() + "quadratic", 0.032f);
-				}
-				for(unsigned int i = lightSpotCounter; i < maxLightSpot; ++i)
-				{
-					ss.str(std::string());
-					ss << "spotLights[" << i << "].";
-					shader->SetUniform(ss.str() + "position", vec3(0.f, 0.f, 0.f));
-					shader->SetUniform(ss.str() + "color", vec3(0.f, 0.f, 0.f));
-					shader->SetUniform(ss.str() + "constant", 1.0f);
-					shader->SetUniform(ss.str() + "linear", 0.09f);
-					shader->SetUniform(ss.str() + "quadratic", 0.032f);
-					shader->SetUniform(ss.str() + "direction", vec3(0.f, 0.f, 1.f));
-					shader->SetUniform(ss.str() + "cutOff", 0.9f);
-					shader->SetUniform(ss.str() + "outerCutOff", 0.82f);
-				}
+				continue;
 			}
 
-			this->RenderMeshNode(rootMeshNode, shader);
+			auto &block = mLightBlock.dirLights[lightDirCounter++];
+			block.direction = vec4(cameraTransform->InverseTransformDirection(lightTransform->Forward()), 0.f);
+			block.color = color;
 		}
+		else if(light->GetType() == LightType::LIGHT_POINT)
+		{
+			if(lightPointCounter >= MaxPointLights)
+			{
+				continue;
+			}
+
+			auto &block = mLightBlock.pointLights[lightPointCounter++];
+			block.position = vec4(cameraTransform->InverseTransformPoint(lightTransform->GetPosition()), 1.f);
+			block.color = color;
+			block.attenuation = vec4(1.f, light->GetLinearAttenuation(), light->GetQuadraticAttenuation(), 0.f);
+		}
+		else if(light->GetType() == LightType::LIGHT_SPOT)
+		{
+			if(lightSpotCounter >= MaxSpotLights)
+			{
+				continue;
+			}
+
+			auto &block = mLightBlock.spotLights[lightSpotCounter++];
+			block.position = vec4(cameraTransform->InverseTransformPoint(lightTransform->GetPosition()), 1.f);
+			block.color = color;
+			block.direction = vec4(cameraTransform->InverseTransformDirection(lightTransform->Forward()), 0.f);
+			block.attenuation = vec4(1.f, light->GetLinearAttenuation(), light->GetQuadraticAttenuation(), 0.f);
+			block.cutOff = vec4(light->GetSpotCutOff(), light->GetSpotOuterCutOff(), 0.f, 0.f);
+		}
+	}
+
+	// Set to zero all remaining lights
+	for(unsigned int i = lightDirCounter; i < MaxDirLights; ++i)
+	{
+		mLightBlock.dirLights[i] = { vec4(0.f, 0.f, 1.f, 0.f), vec4(0.f, 0.f, 0.f, 1.f) };
+	}
+	for(unsigned int i = lightPointCounter; i < MaxPointLights; ++i)
+	{
+		mLightBlock.pointLights[i] = { vec4(0.f, 0.f, 0.f, 1.f), vec4(0.f, 0.f, 0.f, 1.f), vec4(1.f, 0.09f, 0.032f, 0.f) };
+	}
+	for(unsigned int i = lightSpotCounter; i < MaxSpotLights; ++i)
+	{
+		mLightBlock.spotLights[i] = { vec4(0.f, 0.f, 0.f, 1.f), vec4(0.f, 0.f, 0.f, 1.f), vec4(0.f, 0.f, 1.f, 0.f), vec4(1.f, 0.09f, 0.032f, 0.f), vec4(0.9f, 0.82f, 0.f, 0.f) };
 	}
 }
 
-void ForwardRenderer::RenderMeshNode(MeshNode* meshNode, Shader* shader)
+// Uniforms shared by every draw of the camera, they are set once per shader. The shaders
+// declaring the "World" and "Light" uniform blocks read them from the buffers instead.
+void ForwardRenderer::SetShaderUniforms(Shader* shader, Transform* cameraTransform, World* world)
 {
-	for(auto &mesh : meshNode->GetMeshList())
+	// TEMP (World):
+	if(world && ! shader->HasUniformBlock("World"))
 	{
-		mesh->Use(shader);
+		shader->SetUniform("world.ambient", world->GetAmbientColor() * world->GetAmbientIntensity());
+	}
 
-		glDrawElements(Mesh::GetDrawModeGL(mesh->GetDrawMode()), mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+	// TEMP (Others):
+	shader->SetUniform("cameraPosition", cameraTransform->GetPosition());
+	//shader->SetUniform("lightPosition", vec3(lights[0]->Get<Transform>()->GetPosition())); // Gouraud Shading
+
+	if(shader->HasUniformBlock("Light"))
+	{
+		return;
+	}
+
+	// TEMP (Lights):
+	std::stringstream ss;
+
+	for(unsigned int i = 0; i < MaxDirLights; ++i)
+	{
+		auto &block = mLightBlock.dirLights[i];
+
+		ss.str(std::string());
+		ss << "dirLights[" << i << "].";
+		shader->SetUniform(ss.str() + "direction", vec3(block.direction));
+		shader->SetUniform(ss.str() + "color", vec3(block.color));
+	}
+	for(unsigned int i = 0; i < MaxPointLights; ++i)
+	{
+		auto &block = mLightBlock.pointLights[i];
+
+		ss.str(std::string());
+		ss << "pointLights[" << i << "].";
+		shader->SetUniform(ss.str() + "position", vec3(block.position));
+		shader->SetUniform(ss.str() + "color", vec3(block.color));
+		shader->SetUniform(ss.str() + "constant", block.attenuation.x);
+		shader->SetUniform(ss.str() + "linear", block.attenuation.y);
+		shader->SetUniform(ss.str() + "quadratic", block.attenuation.z);
+	}
+	for(unsigned int i = 0; i < MaxSpotLights; ++i)
+	{
+		auto &block = mLightBlock.spotLights[i];
+
+		ss.str(std::string());
+		ss << "spotLights[" << i << "].";
+		shader->SetUniform(ss.str() + "position", vec3(block.position));
+		shader->SetUniform(ss.str() + "color", vec3(block.color));
+		shader->SetUniform(ss.str() + "constant", block.attenuation.x);
+		shader->SetUniform(ss.str() + "linear", block.attenuation.y);
+		shader->SetUniform(ss.str() + "quadratic", block.attenuation.z);
+		shader->SetUniform(ss.str() + "direction", vec3(block.direction));
+		shader->SetUniform(ss.str() + "cutOff", block.cutOff.x);
+		shader->SetUniform(ss.str() + "outerCutOff", block.cutOff.y);
+	}
+}
+
+// The mesh renderers without a shader are not drawn
+void ForwardRenderer::QueueMeshNode(MeshNode* meshNode, Shader* shader, const mat4* modelMatrix, const mat3* normalMatrix, const float depth)
+{
+	if(shader == nullptr)
+	{
+		return;
+	}
+
+	for(auto &mesh : meshNode->GetMeshList())
+	{
+		mRenderQueue.Add(0, shader, mesh->GetMaterial(), mesh, modelMatrix, normalMatrix, depth);
 	}
 
 	for(auto &childMeshNode : meshNode->GetMeshNodeList())
 	{
-		this->RenderMeshNode(childMeshNode, shader);
+		QueueMeshNode(childMeshNode, shader, modelMatrix, normalMatrix, depth);
+	}
+}
+
+// A new pool can be allocated at the address of a destroyed one, so its groups can't be reused
+void ForwardRenderer::Reset()
+{
+	Renderer::Reset();
+
+	mPoolGroups.clear();
+	ClearFrameEntities();
+}
+
+// The vectors keep their capacity between frames, but not the entities (they would be retained)
+void ForwardRenderer::ClearFrameEntities()
+{
+	mCameras.clear();
+	mEntities.clear();
+	mEntityMatrices.clear();
+	mEntityNormalMatrices.clear();
+	mEntityVisibility.clear();
+	mLights.clear();
+}
+
+// The components of the Archetype and SparseSet pools move in memory, a parent pointer would dangle
+void ForwardRenderer::CheckTransformParents(const std::vector<EntityPtr>& entities)
+{
+	for(const auto &entity : entities)
+	{
+		if(entity->Get<Transform>()->GetParent() != nullptr)
+		{
+			ThrowRuntimeError("Error, entity (%u) has a transform with a parent, parents need a pool with the Pointer storage mode", entity->GetUuid());
+		}
+	}
+}
+
+// The groups are resolved once per registered pool
+void ForwardRenderer::UpdatePoolGroups()
+{
+	bool changed = (mPoolGroups.size() != mPools.size());
+
+	for(unsigned int i = 0, count = mPools.size(); ! changed && i < count; ++i)
+	{
+		changed = (mPoolGroups[i].cameras.GetPool() != mPools[i]);
+	}
+
+	if(! changed)
+	{
+		return;
+	}
+
+	mPoolGroups.clear();
+
+	for(const auto &pool : mPools)
+	{
+		// The world matrices of the pools with stable component pointers are updated in a single pass
+		std::shared_ptr<TransformHierarchy> hierarchy;
+
+		if(pool->GetStorageMode() == PoolStorageMode::Pointer)
+		{
+			hierarchy = std::make_shared<TransformHierarchy>(pool);
+		}
+
+		mPoolGroups.push_back({
+			GroupHandle(pool, Matcher_AllOf(Transform, Camera)),
+			GroupHandle(pool, Matcher_AllOf(Transform, MeshRenderer)),
+			GroupHandle(pool, Matcher_AllOf(Transform, Light)),
+			GroupHandle(pool, Matcher_AllOf(World)),
+			hierarchy
+		});
 	}
 }
 }
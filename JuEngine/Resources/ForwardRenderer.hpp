@@ -4,10 +4,18 @@
 
 #pragma once
 
+#include "FrustumCuller.hpp"
+#include "GLRenderBackend.hpp"
 #include "Renderer.hpp"
+#include "RenderQueue.hpp"
+#include "TransformHierarchy.hpp"
+#include "../Entity/GroupHandle.hpp"
 
 namespace JuEngine
 {
+class MeshNode;
+class World;
+
 class JUENGINEAPI ForwardRenderer : public Renderer
 {
 	public:
@@ -15,18 +23,86 @@ class JUENGINEAPI ForwardRenderer : public Renderer
 		~ForwardRenderer();
 
 		void Render();
-
-	protected:
-		void RenderMeshNode(MeshNode* meshNode, Shader* shader);
+		void Reset();
 
 	private:
+		struct PoolGroups
+		{
+			GroupHandle cameras;
+			GroupHandle entities;
+			GroupHandle lights;
+			GroupHandle worlds;
+			std::shared_ptr<TransformHierarchy> hierarchy;
+		};
+
+		// std140 layouts of the "World" and "Light" uniform blocks (positions and directions in view space)
+		struct WorldBlock
+		{
+			vec4 ambientColor;
+			float ambientIntensity;
+			float lightAttenuation;
+			float gammaCorrection;
+			float padding;
+		};
+
+		struct DirLightBlock
+		{
+			vec4 direction;
+			vec4 color;
+		};
+
+		struct PointLightBlock
+		{
+			vec4 position;
+			vec4 color;
+			vec4 attenuation; // constant, linear, quadratic
+		};
+
+		struct SpotLightBlock
+		{
+			vec4 position;
+			vec4 color;
+			vec4 direction;
+			vec4 attenuation; // constant, linear, quadratic
+			vec4 cutOff; // inner, outer
+		};
+
+		static const unsigned int MaxDirLights = 2;
+		static const unsigned int MaxPointLights = 5;
+		static const unsigned int MaxSpotLights = 1;
+
+		struct LightBlock
+		{
+			DirLightBlock dirLights[MaxDirLights];
+			PointLightBlock pointLights[MaxPointLights];
+			SpotLightBlock spotLights[MaxSpotLights];
+		};
+
+		void UpdatePoolGroups();
+		void ClearFrameEntities();
+		void CheckTransformParents(const std::vector<EntityPtr>& entities);
+		void PackLights(Transform* cameraTransform, const std::vector<EntityPtr>& lights);
+		void SetShaderUniforms(Shader* shader, Transform* cameraTransform, World* world);
+		void QueueMeshNode(MeshNode* meshNode, Shader* shader, const mat4* modelMatrix, const mat3* normalMatrix, const float depth);
+
+		std::vector<PoolGroups> mPoolGroups;
+		std::vector<EntityPtr> mCameras;
+		std::vector<EntityPtr> mEntities;
+		std::vector<const mat4*> mEntityMatrices;
+		std::vector<mat3> mEntityNormalMatrices;
+		std::vector<unsigned char> mEntityVisibility;
+		std::vector<EntityPtr> mLights;
+		RenderQueue mRenderQueue;
+		FrustumCuller mCuller;
+		GLRenderBackend mBackend;
 		uint32_t mGlobalMatrixBindingIndex{0};
 		uint32_t mGlobalMatrixUBO;
-		//uint32_t mWorldBindingIndex{1};
-		//uint32_t mWorldUBO;
-		//uint32_t mMaterialBindingIndex{2};
-		//uint32_t mMaterialUBO;
-		//uint32_t mLightBindingIndex{3};
-		//uint32_t mLightUBO;
+		uint32_t mWorldBindingIndex{1};
+		uint32_t mWorldUBO;
+		uint32_t mMaterialBindingIndex{2};
+		uint32_t mMaterialUBO;
+		uint32_t mLightBindingIndex{3};
+		uint32_t mLightUBO;
+		LightBlock mLightBlock;
 };
 }
@@ -0,0 +1,110 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "Frustum.hpp"
+#include <cmath>
+
+namespace JuEngine
+{
+const unsigned int Frustum::PlaneCount;
+
+// The planes are extracted from the rows of the matrix (Gribb & Hartmann), in the space the
+// matrix transforms from (world space with the view projection matrix of a camera)
+Frustum::Frustum(const mat4& viewProjectionMatrix)
+{
+	auto &m = viewProjectionMatrix;
+	vec4 rows[4];
+
+	for(unsigned int row = 0; row < 4; ++row)
+	{
+		rows[row] = vec4(m[0][row], m[1][row], m[2][row], m[3][row]);
+	}
+
+	mPlanes[0] = rows[3] + rows[0];
+	mPlanes[1] = rows[3] - rows[0];
+	mPlanes[2] = rows[3] + rows[1];
+	mPlanes[3] = rows[3] - rows[1];
+	mPlanes[4] = rows[3] + rows[2];
+	mPlanes[5] = rows[3] - rows[2];
+
+	for(auto &plane : mPlanes)
+	{
+		float length = std::sqrt(plane.x * plane.x + plane.y * plane.y + plane.z * plane.z);
+
+		if(length > 0.f)
+		{
+			plane /= length;
+		}
+	}
+}
+
+auto Frustum::GetPlane(const unsigned int index) const -> const vec4&
+{
+	return mPlanes[index];
+}
+
+auto Frustum::Intersects(const BoundingBox& box) const -> bool
+{
+	if(box.IsEmpty())
+	{
+		return false;
+	}
+
+	vec3 center = box.GetCenter();
+	vec3 extents = box.GetExtents();
+
+	for(const auto &plane : mPlanes)
+	{
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+
+		if(distance + radius < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+// The box is completely inside, it doesn't reach the outer side of any plane
+auto Frustum::Contains(const BoundingBox& box) const -> bool
+{
+	if(box.IsEmpty())
+	{
+		return false;
+	}
+
+	vec3 center = box.GetCenter();
+	vec3 extents = box.GetExtents();
+
+	for(const auto &plane : mPlanes)
+	{
+		float distance = plane.x * center.x + plane.y * center.y + plane.z * center.z + plane.w;
+		float radius = std::abs(plane.x) * extents.x + std::abs(plane.y) * extents.y + std::abs(plane.z) * extents.z;
+
+		if(distance - radius < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+auto Frustum::Intersects(const BoundingSphere& sphere) const -> bool
+{
+	for(const auto &plane : mPlanes)
+	{
+		float distance = plane.x * sphere.center.x + plane.y * sphere.center.y + plane.z * sphere.center.z + plane.w;
+
+		if(distance + sphere.radius < 0.f)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+}
@@ -0,0 +1,27 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "BoundingVolume.hpp"
+
+namespace JuEngine
+{
+// Six planes (left, right, bottom, top, near, far) with their normals pointing inside
+class JUENGINEAPI Frustum
+{
+	public:
+		Frustum(const mat4& viewProjectionMatrix);
+
+		auto GetPlane(const unsigned int index) const -> const vec4&;
+		auto Intersects(const BoundingBox& box) const -> bool;
+		auto Contains(const BoundingBox& box) const -> bool;
+		auto Intersects(const BoundingSphere& sphere) const -> bool;
+
+		static const unsigned int PlaneCount = 6;
+
+	private:
+		vec4 mPlanes[PlaneCount];
+};
+}
@@ -0,0 +1,119 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "FrustumCuller.hpp"
+#include <cmath>
+
+#ifdef JUENGINE_SIMD_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace JuEngine
+{
+// Empty boxes get a huge negative extent, so they are outside of any plane
+static const float EmptyExtent = -1e30f;
+
+void FrustumCuller::Clear()
+{
+	mCenterX.clear();
+	mCenterY.clear();
+	mCenterZ.clear();
+	mExtentX.clear();
+	mExtentY.clear();
+	mExtentZ.clear();
+}
+
+void FrustumCuller::Reserve(const unsigned int count)
+{
+	mCenterX.reserve(count);
+	mCenterY.reserve(count);
+	mCenterZ.reserve(count);
+	mExtentX.reserve(count);
+	mExtentY.reserve(count);
+	mExtentZ.reserve(count);
+}
+
+void FrustumCuller::Add(const BoundingBox& box)
+{
+	vec3 center = (box.IsEmpty() ? vec3(0.f) : box.GetCenter());
+	vec3 extents = (box.IsEmpty() ? vec3(EmptyExtent) : box.GetExtents());
+
+	mCenterX.push_back(center.x);
+	mCenterY.push_back(center.y);
+	mCenterZ.push_back(center.z);
+	mExtentX.push_back(extents.x);
+	mExtentY.push_back(extents.y);
+	mExtentZ.push_back(extents.z);
+}
+
+auto FrustumCuller::Count() const -> unsigned int
+{
+	return mCenterX.size();
+}
+
+// A box is outside when its projected radius doesn't reach the inner side of any plane.
+// Returns the number of visible boxes, visible must have room for Count() elements.
+auto FrustumCuller::Cull(const Frustum& frustum, unsigned char* visible) const -> unsigned int
+{
+	unsigned int count = Count();
+	unsigned int visibleCount = 0;
+	unsigned int i = 0;
+
+#ifdef JUENGINE_SIMD_SSE
+	const __m128 zero = _mm_setzero_ps();
+
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 cx = _mm_loadu_ps(&mCenterX[i]);
+		__m128 cy = _mm_loadu_ps(&mCenterY[i]);
+		__m128 cz = _mm_loadu_ps(&mCenterZ[i]);
+		__m128 ex = _mm_loadu_ps(&mExtentX[i]);
+		__m128 ey = _mm_loadu_ps(&mExtentY[i]);
+		__m128 ez = _mm_loadu_ps(&mExtentZ[i]);
+		__m128 outside = zero;
+
+		for(unsigned int p = 0; p < Frustum::PlaneCount; ++p)
+		{
+			auto &plane = frustum.GetPlane(p);
+
+			__m128 distance = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.x), cx), _mm_mul_ps(_mm_set1_ps(plane.y), cy)),
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(plane.z), cz), _mm_set1_ps(plane.w)));
+			__m128 radius = _mm_add_ps(
+				_mm_add_ps(_mm_mul_ps(_mm_set1_ps(std::abs(plane.x)), ex), _mm_mul_ps(_mm_set1_ps(std::abs(plane.y)), ey)),
+				_mm_mul_ps(_mm_set1_ps(std::abs(plane.z)), ez));
+
+			outside = _mm_or_ps(outside, _mm_cmplt_ps(_mm_add_ps(distance, radius), zero));
+		}
+
+		int mask = _mm_movemask_ps(outside);
+
+		for(unsigned int k = 0; k < 4; ++k)
+		{
+			visible[i + k] = ((mask >> k) & 1) ? 0 : 1;
+			visibleCount += visible[i + k];
+		}
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		bool outside = false;
+
+		for(unsigned int p = 0; ! outside && p < Frustum::PlaneCount; ++p)
+		{
+			auto &plane = frustum.GetPlane(p);
+			float distance = plane.x * mCenterX[i] + plane.y * mCenterY[i] + plane.z * mCenterZ[i] + plane.w;
+			float radius = std::abs(plane.x) * mExtentX[i] + std::abs(plane.y) * mExtentY[i] + std::abs(plane.z) * mExtentZ[i];
+
+			outside = (distance + radius < 0.f);
+		}
+
+		visible[i] = outside ? 0 : 1;
+		visibleCount += visible[i];
+	}
+
+	return visibleCount;
+}
+}
@@ -0,0 +1,33 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "Frustum.hpp"
+#include "TransformBatch.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+// World space boxes of many objects stored per component (SoA), so they are tested against
+// the planes of a frustum four at a time with SSE. The boxes are added once and culled per camera.
+class JUENGINEAPI FrustumCuller
+{
+	public:
+		void Clear();
+		void Reserve(const unsigned int count);
+		void Add(const BoundingBox& box);
+		auto Count() const -> unsigned int;
+
+		auto Cull(const Frustum& frustum, unsigned char* visible) const -> unsigned int;
+
+	private:
+		std::vector<float> mCenterX;
+		std::vector<float> mCenterY;
+		std::vector<float> mCenterZ;
+		std::vector<float> mExtentX;
+		std::vector<float> mExtentY;
+		std::vector<float> mExtentZ;
+};
+}
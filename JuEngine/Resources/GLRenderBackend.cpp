@@ -0,0 +1,121 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "GLRenderBackend.hpp"
+#include "Material.hpp"
+#include "Mesh.hpp"
+#include "Shader.hpp"
+#include <GL/glew.h>
+
+namespace JuEngine
+{
+const uint32_t GLRenderBackend::InstanceModelMatrixLocation;
+const uint32_t GLRenderBackend::InstanceNormalMatrixLocation;
+
+GLRenderBackend::~GLRenderBackend()
+{
+	if(mInstanceVBO)
+	{
+		glDeleteBuffers(1, &mInstanceVBO);
+	}
+}
+
+void GLRenderBackend::SetMaterialBuffer(const uint32_t materialUBO)
+{
+	mMaterialUBO = materialUBO;
+}
+
+void GLRenderBackend::UseShader(Shader* shader)
+{
+	mMaterialBlockUsed = false;
+
+	if(shader != nullptr)
+	{
+		shader->Use();
+		mMaterialBlockUsed = (mMaterialUBO != 0 && shader->HasUniformBlock("Material"));
+	}
+}
+
+void GLRenderBackend::UseMesh(Mesh* mesh)
+{
+	mesh->Bind();
+}
+
+void GLRenderBackend::UseMaterial(Material* material, Shader* shader)
+{
+	if(! mMaterialBlockUsed)
+	{
+		material->Use(shader);
+
+		return;
+	}
+
+	MaterialBlock block = {
+		vec4(material->GetDiffuseColor(), 1.f),
+		vec4(material->GetSpecularColor(), 1.f),
+		material->GetShininessFactor(),
+		{0.f, 0.f, 0.f}
+	};
+
+	glBindBuffer(GL_UNIFORM_BUFFER, mMaterialUBO);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(MaterialBlock), &block);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	material->UseTextures(shader);
+}
+
+void GLRenderBackend::SetDrawUniforms(Shader* shader, const mat4& modelMatrix, const mat3& normalMatrix)
+{
+	shader->SetUniform("modelToWorldMatrix", modelMatrix);
+	shader->SetUniform("normalMatrix", normalMatrix);
+}
+
+void GLRenderBackend::Draw(Mesh* mesh)
+{
+	glDrawElements(Mesh::GetDrawModeGL(mesh->GetDrawMode()), mesh->GetIndexCount(), GL_UNSIGNED_INT, 0);
+}
+
+auto GLRenderBackend::CanDrawInstanced(Shader* shader) const -> bool
+{
+	return shader->IsInstanced();
+}
+
+// The buffer is orphaned before every upload so the draws still using it aren't waited on.
+// The per-instance attributes are set in the VAO of the mesh, the rest of shaders ignore them.
+void GLRenderBackend::DrawInstanced(Mesh* mesh, const RenderInstance* instances, const unsigned int count)
+{
+	if(! mInstanceVBO)
+	{
+		glGenBuffers(1, &mInstanceVBO);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, mInstanceVBO);
+
+	if(count > mInstanceCapacity)
+	{
+		mInstanceCapacity = (count > mInstanceCapacity * 2 ? count : mInstanceCapacity * 2);
+	}
+
+	glBufferData(GL_ARRAY_BUFFER, mInstanceCapacity * sizeof(RenderInstance), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(RenderInstance), instances);
+
+	for(uint32_t column = 0; column < 4; ++column)
+	{
+		glVertexAttribPointer(InstanceModelMatrixLocation + column, 4, GL_FLOAT, GL_FALSE, sizeof(RenderInstance), (void*)(column * sizeof(vec4)));
+		glVertexAttribDivisor(InstanceModelMatrixLocation + column, 1);
+		glEnableVertexAttribArray(InstanceModelMatrixLocation + column);
+	}
+
+	for(uint32_t column = 0; column < 3; ++column)
+	{
+		glVertexAttribPointer(InstanceNormalMatrixLocation + column, 3, GL_FLOAT, GL_FALSE, sizeof(RenderInstance), (void*)(sizeof(mat4) + column * sizeof(vec3)));
+		glVertexAttribDivisor(InstanceNormalMatrixLocation + column, 1);
+		glEnableVertexAttribArray(InstanceNormalMatrixLocation + column);
+	}
+
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	glDrawElementsInstanced(Mesh::GetDrawModeGL(mesh->GetDrawMode()), mesh->GetIndexCount(), GL_UNSIGNED_INT, 0, count);
+}
+}
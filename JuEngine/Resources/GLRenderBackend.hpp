@@ -0,0 +1,45 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "IRenderBackend.hpp"
+
+namespace JuEngine
+{
+class JUENGINEAPI GLRenderBackend : public IRenderBackend
+{
+	public:
+		// std140 layout of the "Material" uniform block
+		struct MaterialBlock
+		{
+			vec4 diffuseColor;
+			vec4 specularColor;
+			float shininess;
+			float padding[3];
+		};
+
+		~GLRenderBackend();
+
+		void SetMaterialBuffer(const uint32_t materialUBO);
+
+		void UseShader(Shader* shader);
+		void UseMesh(Mesh* mesh);
+		void UseMaterial(Material* material, Shader* shader);
+		void SetDrawUniforms(Shader* shader, const mat4& modelMatrix, const mat3& normalMatrix);
+		void Draw(Mesh* mesh);
+		auto CanDrawInstanced(Shader* shader) const -> bool;
+		void DrawInstanced(Mesh* mesh, const RenderInstance* instances, const unsigned int count);
+
+		// Vertex attribute locations of the per-instance data in the instanced shaders
+		static const uint32_t InstanceModelMatrixLocation = 4; // mat4, locations 4 to 7
+		static const uint32_t InstanceNormalMatrixLocation = 8; // mat3, locations 8 to 10
+
+	private:
+		uint32_t mMaterialUBO{0};
+		bool mMaterialBlockUsed{false};
+		uint32_t mInstanceVBO{0};
+		unsigned int mInstanceCapacity{0};
+};
+}
@@ -0,0 +1,37 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../DllExport.hpp"
+#include "Math.hpp"
+
+namespace JuEngine
+{
+class Material;
+class Mesh;
+class Shader;
+
+// Per-instance vertex data of the instanced draws
+struct RenderInstance
+{
+	mat4 modelMatrix;
+	mat3 normalMatrix;
+};
+
+// State changes and draws issued by the render queue, the queue already skips the redundant ones
+class JUENGINEAPI IRenderBackend
+{
+	public:
+		virtual ~IRenderBackend() = default;
+
+		virtual void UseShader(Shader* shader) = 0;
+		virtual void UseMesh(Mesh* mesh) = 0;
+		virtual void UseMaterial(Material* material, Shader* shader) = 0;
+		virtual void SetDrawUniforms(Shader* shader, const mat4& modelMatrix, const mat3& normalMatrix) = 0;
+		virtual void Draw(Mesh* mesh) = 0;
+		virtual auto CanDrawInstanced(Shader* shader) const -> bool = 0;
+		virtual void DrawInstanced(Mesh* mesh, const RenderInstance* instances, const unsigned int count) = 0;
+};
+}
@@ -26,6 +26,16 @@ void Material::Use(Shader* shader)
 	shader->SetUniform("material.specularColor", mSpecularColor);
 	shader->SetUniform("material.shininess", mShininessFactor);
 
+	UseTextures(shader);
+}
+
+void Material::UseTextures(Shader* shader)
+{
+	if(shader == nullptr)
+	{
+		return;
+	}
+
 	unsigned int counter = 0;
 
 	if(! mTextures.empty())
@@ -20,6 +20,7 @@ class JUENGINEAPI Material : public IObject
 		Material();
 
 		void Use(Shader* shader);
+		void UseTextures(Shader* shader);
 
 		auto GetDiffuseColor() -> const vec3&;
 		auto SetDiffuseColor(const vec3 diffuseColor) -> Material*;
@@ -74,6 +74,10 @@ Mesh::Mesh(const std::vector<float>& vertexArray, const std::vector<unsigned int
 
 	mDrawMode = drawMode;
 
+	// Object space bounds from the vertex positions, the buffers don't keep a copy in memory
+	mBoundingBox = BoundingBox::FromPoints(vertexArray.data(), mVertexCount, mNumVertexAttr);
+	mBoundingSphere = BoundingSphere::FromPoints(vertexArray.data(), mVertexCount, mNumVertexAttr, mBoundingBox);
+
 	SetMaterial(material);
 }
 
@@ -86,7 +90,7 @@ Mesh::~Mesh()
 
 void Mesh::Use(Shader* shader)
 {
-	glBindVertexArray(mVAO);
+	Bind();
 
 	if(mMaterial != nullptr)
 	{
@@ -94,6 +98,11 @@ void Mesh::Use(Shader* shader)
 	}
 }
 
+void Mesh::Bind()
+{
+	glBindVertexArray(mVAO);
+}
+
 void Mesh::DisableMeshes()
 {
 	glBindVertexArray(0);
@@ -184,6 +193,16 @@ auto Mesh::GetDrawMode() const -> const MeshDrawMode
 	return mDrawMode;
 }
 
+auto Mesh::GetBoundingBox() const -> const BoundingBox&
+{
+	return mBoundingBox;
+}
+
+auto Mesh::GetBoundingSphere() const -> const BoundingSphere&
+{
+	return mBoundingSphere;
+}
+
 auto Mesh::GetMaterial() const -> Material*
 {
 	return mMaterial;
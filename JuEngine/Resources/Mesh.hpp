@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../Resources/IObject.hpp"
+#include "../Resources/BoundingVolume.hpp"
 #include <vector>
 
 namespace JuEngine
@@ -42,6 +43,7 @@ class JUENGINEAPI Mesh : public IObject
 		~Mesh();
 
 		void Use(Shader* shader);
+		void Bind();
 		static void DisableMeshes();
 		static auto GetNumVertexAttr(MeshVertexFormat meshVertexFormat) -> unsigned int;
 		static auto GetDrawModeGL(MeshDrawMode meshDrawMode) -> const uint32_t;
@@ -50,6 +52,8 @@ class JUENGINEAPI Mesh : public IObject
 		auto GetVertexCount() const -> const unsigned int;
 		auto GetIndexCount() const -> const unsigned int;
 		auto GetDrawMode() const -> const MeshDrawMode;
+		auto GetBoundingBox() const -> const BoundingBox&;
+		auto GetBoundingSphere() const -> const BoundingSphere&;
 
 		auto GetMaterial() const -> Material*;
 		auto SetMaterial(Material* material) -> Mesh*;
@@ -62,6 +66,8 @@ class JUENGINEAPI Mesh : public IObject
 		unsigned int mVertexCount{0};
 		unsigned int mIndexCount{0};
 		MeshDrawMode mDrawMode;
+		BoundingBox mBoundingBox;
+		BoundingSphere mBoundingSphere;
 		Material* mMaterial;
 };
 }
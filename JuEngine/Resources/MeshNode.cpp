@@ -96,6 +96,24 @@ auto MeshNode::GetMaterialList() -> std::vector<Material*>
 	return materialList;
 }
 
+// Object space box of the meshes of the node and all its children
+auto MeshNode::GetBoundingBox() const -> BoundingBox
+{
+	BoundingBox box;
+
+	for(const auto &mesh : mMeshList)
+	{
+		box.Encapsulate(mesh->GetBoundingBox());
+	}
+
+	for(const auto &meshNode : mMeshNodeList)
+	{
+		box.Encapsulate(meshNode->GetBoundingBox());
+	}
+
+	return box;
+}
+
 auto MeshNode::GetTextureList() -> std::vector<Texture*>
 {
 	auto meshList = GetMeshList();
@@ -5,6 +5,7 @@
 #pragma once
 
 #include "../Resources/IObject.hpp"
+#include "../Resources/BoundingVolume.hpp"
 #include <vector>
 
 namespace JuEngine
@@ -28,6 +29,7 @@ class JUENGINEAPI MeshNode : public IObject
 		auto GetMeshList() -> std::vector<Mesh*>;
 		auto GetMaterialList() -> std::vector<Material*>;
 		auto GetTextureList() -> std::vector<Texture*>;
+		auto GetBoundingBox() const -> BoundingBox;
 
 	private:
 		std::vector<MeshNode*> mMeshNodeList;
@@ -0,0 +1,93 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "RecordingRenderBackend.hpp"
+
+namespace JuEngine
+{
+void RecordingRenderBackend::UseShader(Shader* shader)
+{
+	Record(RenderBackendCall::UseShader, shader);
+}
+
+void RecordingRenderBackend::UseMesh(Mesh* mesh)
+{
+	Record(RenderBackendCall::UseMesh, mesh);
+}
+
+void RecordingRenderBackend::UseMaterial(Material* material, Shader* shader)
+{
+	Record(RenderBackendCall::UseMaterial, material);
+}
+
+void RecordingRenderBackend::SetDrawUniforms(Shader* shader, const mat4& modelMatrix, const mat3& normalMatrix)
+{
+	Record(RenderBackendCall::SetDrawUniforms, shader);
+}
+
+void RecordingRenderBackend::Draw(Mesh* mesh)
+{
+	Record(RenderBackendCall::Draw, mesh);
+}
+
+auto RecordingRenderBackend::CanDrawInstanced(Shader* shader) const -> bool
+{
+	return mInstancing;
+}
+
+void RecordingRenderBackend::DrawInstanced(Mesh* mesh, const RenderInstance* instances, const unsigned int count)
+{
+	Record(RenderBackendCall::DrawInstanced, mesh, count);
+	mInstanceCount += count;
+}
+
+void RecordingRenderBackend::SetInstancing(const bool instancing)
+{
+	mInstancing = instancing;
+}
+
+void RecordingRenderBackend::Reset()
+{
+	mCalls.clear();
+	mInstanceCount = 0;
+
+	for(auto &count : mCallCounts)
+	{
+		count = 0;
+	}
+}
+
+auto RecordingRenderBackend::GetCalls() const -> const std::vector<Call>&
+{
+	return mCalls;
+}
+
+auto RecordingRenderBackend::GetCallCount(const RenderBackendCall type) const -> unsigned int
+{
+	return mCallCounts[static_cast<unsigned int>(type)];
+}
+
+// Shader, mesh (VAO) and material (textures) binds
+auto RecordingRenderBackend::GetStateChangeCount() const -> unsigned int
+{
+	return GetCallCount(RenderBackendCall::UseShader) + GetCallCount(RenderBackendCall::UseMesh) + GetCallCount(RenderBackendCall::UseMaterial);
+}
+
+auto RecordingRenderBackend::GetDrawCallCount() const -> unsigned int
+{
+	return GetCallCount(RenderBackendCall::Draw) + GetCallCount(RenderBackendCall::DrawInstanced);
+}
+
+// Objects drawn by the instanced draws
+auto RecordingRenderBackend::GetInstanceCount() const -> unsigned int
+{
+	return mInstanceCount;
+}
+
+void RecordingRenderBackend::Record(const RenderBackendCall type, const void* object, const unsigned int instanceCount)
+{
+	mCalls.push_back({type, object, instanceCount});
+	++mCallCounts[static_cast<unsigned int>(type)];
+}
+}
@@ -0,0 +1,57 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "IRenderBackend.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+enum class RenderBackendCall
+{
+	UseShader,
+	UseMesh,
+	UseMaterial,
+	SetDrawUniforms,
+	Draw,
+	DrawInstanced
+};
+
+// Records the calls instead of issuing them, so the state changes of a frame can be counted without a GPU
+class JUENGINEAPI RecordingRenderBackend : public IRenderBackend
+{
+	public:
+		struct Call
+		{
+			RenderBackendCall type;
+			const void* object;
+			unsigned int instanceCount;
+		};
+
+		void UseShader(Shader* shader);
+		void UseMesh(Mesh* mesh);
+		void UseMaterial(Material* material, Shader* shader);
+		void SetDrawUniforms(Shader* shader, const mat4& modelMatrix, const mat3& normalMatrix);
+		void Draw(Mesh* mesh);
+		auto CanDrawInstanced(Shader* shader) const -> bool;
+		void DrawInstanced(Mesh* mesh, const RenderInstance* instances, const unsigned int count);
+
+		void SetInstancing(const bool instancing);
+		void Reset();
+		auto GetCalls() const -> const std::vector<Call>&;
+		auto GetCallCount(const RenderBackendCall type) const -> unsigned int;
+		auto GetStateChangeCount() const -> unsigned int;
+		auto GetDrawCallCount() const -> unsigned int;
+		auto GetInstanceCount() const -> unsigned int;
+
+	private:
+		void Record(const RenderBackendCall type, const void* object, const unsigned int instanceCount = 0);
+
+		std::vector<Call> mCalls;
+		unsigned int mCallCounts[6] = {0, 0, 0, 0, 0, 0};
+		unsigned int mInstanceCount{0};
+		bool mInstancing{false};
+};
+}
@@ -0,0 +1,177 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "RenderQueue.hpp"
+#include <cstring>
+
+namespace JuEngine
+{
+// The ids are given again each frame, so they only alias when a single frame uses more objects
+// than their bits can tell apart (and the destroyed objects don't keep their ids)
+void RenderQueue::Clear()
+{
+	mCommands.clear();
+	mOrder.clear();
+	mShaderIds.clear();
+	mMaterialIds.clear();
+	mMeshIds.clear();
+}
+
+void RenderQueue::Add(const unsigned int pass, Shader* shader, Material* material, Mesh* mesh, const mat4* modelMatrix, const mat3* normalMatrix, const float depth)
+{
+	auto key = MakeKey(pass, GetId(mShaderIds, shader), GetId(mMaterialIds, material), GetId(mMeshIds, mesh), depth);
+
+	mOrder.push_back({key, (unsigned int)mCommands.size()});
+	mCommands.push_back({key, shader, material, mesh, modelMatrix, normalMatrix});
+}
+
+// LSD radix sort of 8 bits per pass, the passes where every key has the same byte are skipped
+void RenderQueue::Sort()
+{
+	unsigned int count = mOrder.size();
+
+	mSortBuffer.resize(count);
+
+	for(unsigned int shift = 0; shift < 64; shift += 8)
+	{
+		unsigned int offsets[256] = {0};
+
+		for(const auto &item : mOrder)
+		{
+			++offsets[(item.key >> shift) & 0xFF];
+		}
+
+		if(count == 0 || offsets[(mOrder[0].key >> shift) & 0xFF] == count)
+		{
+			continue;
+		}
+
+		for(unsigned int i = 0, sum = 0; i < 256; ++i)
+		{
+			auto digitCount = offsets[i];
+			offsets[i] = sum;
+			sum += digitCount;
+		}
+
+		for(const auto &item : mOrder)
+		{
+			mSortBuffer[offsets[(item.key >> shift) & 0xFF]++] = item;
+		}
+
+		mOrder.swap(mSortBuffer);
+	}
+}
+
+// The state is only changed when it differs from the previous command, the material is applied
+// again after a shader change because its uniforms belong to the shader program
+void RenderQueue::Submit(IRenderBackend* backend, const std::function<void(Shader* shader)>& prepareShader)
+{
+	Shader* shader = nullptr;
+	Material* material = nullptr;
+	Mesh* mesh = nullptr;
+	bool first = true;
+	bool instanced = false;
+
+	for(unsigned int i = 0, count = mOrder.size(); i < count; ++i)
+	{
+		auto &command = mCommands[mOrder[i].command];
+
+		if(first || command.shader != shader)
+		{
+			shader = command.shader;
+			material = nullptr;
+			first = false;
+
+			backend->UseShader(shader);
+			instanced = (shader != nullptr && backend->CanDrawInstanced(shader));
+
+			if(shader != nullptr && prepareShader)
+			{
+				prepareShader(shader);
+			}
+		}
+
+		if(command.mesh != mesh)
+		{
+			mesh = command.mesh;
+			backend->UseMesh(mesh);
+		}
+
+		if(command.material != nullptr && command.material != material)
+		{
+			material = command.material;
+			backend->UseMaterial(material, shader);
+		}
+
+		if(instanced)
+		{
+			mInstances.clear();
+			mInstances.push_back({*command.modelMatrix, *command.normalMatrix});
+
+			for(; i + 1 < count; ++i)
+			{
+				auto &next = mCommands[mOrder[i + 1].command];
+
+				if(next.shader != shader || next.material != command.material || next.mesh != mesh)
+				{
+					break;
+				}
+
+				mInstances.push_back({*next.modelMatrix, *next.normalMatrix});
+			}
+
+			backend->DrawInstanced(mesh, mInstances.data(), mInstances.size());
+
+			continue;
+		}
+
+		if(shader != nullptr)
+		{
+			backend->SetDrawUniforms(shader, *command.modelMatrix, *command.normalMatrix);
+		}
+
+		backend->Draw(mesh);
+	}
+}
+
+auto RenderQueue::GetCommands() const -> const std::vector<RenderCommand>&
+{
+	return mCommands;
+}
+
+auto RenderQueue::Count() const -> unsigned int
+{
+	return mCommands.size();
+}
+
+// The bits of a positive float keep the order, the top 16 bits are enough to sort by depth
+auto RenderQueue::MakeKey(const unsigned int pass, const unsigned int shaderId, const unsigned int materialId, const unsigned int meshId, const float depth) -> std::uint64_t
+{
+	std::uint32_t depthBits = 0;
+	float positiveDepth = (depth > 0.f ? depth : 0.f);
+
+	std::memcpy(&depthBits, &positiveDepth, sizeof(depthBits));
+
+	return (static_cast<std::uint64_t>(pass & 0xF) << 60) |
+		(static_cast<std::uint64_t>(shaderId & 0xFFF) << 48) |
+		(static_cast<std::uint64_t>(materialId & 0xFFFF) << 32) |
+		(static_cast<std::uint64_t>(meshId & 0xFFFF) << 16) |
+		(depthBits >> 16);
+}
+
+auto RenderQueue::GetId(std::unordered_map<const void*, unsigned int>& ids, const void* object) -> unsigned int
+{
+	auto it = ids.find(object);
+
+	if(it != ids.end())
+	{
+		return it->second;
+	}
+
+	unsigned int id = ids.size();
+	ids[object] = id;
+
+	return id;
+}
+}
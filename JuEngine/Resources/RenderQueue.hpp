@@ -0,0 +1,59 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "IRenderBackend.hpp"
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace JuEngine
+{
+struct RenderCommand
+{
+	std::uint64_t key;
+	Shader* shader;
+	Material* material;
+	Mesh* mesh;
+	const mat4* modelMatrix;
+	const mat3* normalMatrix;
+};
+
+// Draws are sorted by a 64 bit key so the commands sharing state are submitted together:
+// pass (4 bits) | shader (12 bits) | material (16 bits) | mesh (16 bits) | depth (16 bits)
+// The ids are only used for sorting, two objects sharing an id are still bound separately.
+// Consecutive commands sharing shader, material and mesh are drawn as a single instanced draw
+// when the backend can draw the shader instanced.
+class JUENGINEAPI RenderQueue
+{
+	public:
+		void Clear();
+		void Add(const unsigned int pass, Shader* shader, Material* material, Mesh* mesh, const mat4* modelMatrix, const mat3* normalMatrix, const float depth);
+		void Sort();
+		void Submit(IRenderBackend* backend, const std::function<void(Shader* shader)>& prepareShader = nullptr);
+		auto GetCommands() const -> const std::vector<RenderCommand>&;
+		auto Count() const -> unsigned int;
+
+		static auto MakeKey(const unsigned int pass, const unsigned int shaderId, const unsigned int materialId, const unsigned int meshId, const float depth) -> std::uint64_t;
+
+	private:
+		struct SortItem
+		{
+			std::uint64_t key;
+			unsigned int command;
+		};
+
+		static auto GetId(std::unordered_map<const void*, unsigned int>& ids, const void* object) -> unsigned int;
+
+		std::vector<RenderCommand> mCommands;
+		std::vector<SortItem> mOrder;
+		std::vector<SortItem> mSortBuffer;
+		std::vector<RenderInstance> mInstances;
+		std::unordered_map<const void*, unsigned int> mShaderIds;
+		std::unordered_map<const void*, unsigned int> mMaterialIds;
+		std::unordered_map<const void*, unsigned int> mMeshIds;
+};
+}
@@ -10,8 +10,6 @@
 namespace JuEngine
 {
 class Pool;
-class MeshNode;
-class Shader;
 
 class JUENGINEAPI Renderer : public IObject
 {
@@ -21,11 +19,9 @@ class JUENGINEAPI Renderer : public IObject
 		virtual void Render() = 0;
 
 		void Register(Pool* pool);
-		void Reset();
+		virtual void Reset();
 
 	protected:
-		virtual void RenderMeshNode(MeshNode* meshNode, Shader* shader) = 0;
-
 		std::vector<Pool*> mPools;
 };
 }
@@ -3,8 +3,10 @@
 // GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
 
 #include "Shader.hpp"
+#include "GLRenderBackend.hpp"
 #include "../App.hpp"
 #include "../Services/IDataService.hpp"
+#include <algorithm>
 #include <fstream>
 #include <streambuf>
 #include <sstream>
@@ -99,10 +101,30 @@ void Shader::SetUniformTexture(const std::string& name, const unsigned int index
 	glUniform1i(GetUniformLocation(name), index);
 }
 
-void Shader::BindUniformBlock(const std::string& name, const uint32_t mUniformBufferBindingIndex)
+bool Shader::BindUniformBlock(const std::string& name, const uint32_t mUniformBufferBindingIndex)
 {
 	auto location = GetUniformBlockLocation(mShaderProgram, name);
+
+	if(location == (int32_t)GL_INVALID_INDEX)
+	{
+		return false;
+	}
+
 	glUniformBlockBinding(mShaderProgram, location, mUniformBufferBindingIndex);
+	mUniformBlocks.push_back(name);
+
+	return true;
+}
+
+bool Shader::HasUniformBlock(const std::string& name) const
+{
+	return std::find(mUniformBlocks.begin(), mUniformBlocks.end(), name) != mUniformBlocks.end();
+}
+
+// Instanced shaders read the model and normal matrices from per-instance vertex attributes
+bool Shader::IsInstanced() const
+{
+	return mInstanced;
 }
 
 void Shader::AddShader(const ShaderType shaderType, const std::string& shaderPath)
@@ -174,10 +196,21 @@ void Shader::Reload(const bool forceLoad)
 		lastShaderProgram = 0;
 
 		// TODO: Shader: UBO indexes -> Renderer (ForwardRenderer)
+		// The renderer only sets the plain uniforms of the blocks the shader doesn't declare
+		mUniformBlocks.clear();
 		BindUniformBlock("GlobalMatrices", 0);
-		//BindUniformBlock("World", 1);
-		//BindUniformBlock("Material", 2);
-		//BindUniformBlock("Light", 3);
+		BindUniformBlock("World", 1);
+		BindUniformBlock("Material", 2);
+		BindUniformBlock("Light", 3);
+
+		auto instanceLocation = glGetAttribLocation(mShaderProgram, "instanceModelMatrix");
+		mInstanced = (instanceLocation != -1);
+
+		if(mInstanced && instanceLocation != (GLint)GLRenderBackend::InstanceModelMatrixLocation)
+		{
+			App::Log()->Warning("Warning, instanceModelMatrix must use the attribute location %u, instancing disabled", GLRenderBackend::InstanceModelMatrixLocation);
+			mInstanced = false;
+		}
 
 		mUniformCache.clear();
 	}
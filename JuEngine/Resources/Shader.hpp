@@ -40,7 +40,9 @@ class JUENGINEAPI Shader : public IObject
 		void SetUniform(const std::string& name, const mat3 matrix);
 		void SetUniform(const std::string& name, const mat4 matrix);
 		void SetUniformTexture(const std::string& name, const unsigned int index);
-		void BindUniformBlock(const std::string& name, const uint32_t mUniformBufferBindingIndex);
+		bool BindUniformBlock(const std::string& name, const uint32_t mUniformBufferBindingIndex);
+		bool HasUniformBlock(const std::string& name) const;
+		bool IsInstanced() const;
 
 		void AddShader(const ShaderType shaderType, const std::string& shaderPath);
 		void Reload(const bool forceLoad = false);
@@ -58,7 +60,9 @@ class JUENGINEAPI Shader : public IObject
 		static auto GetUniformBlockLocation(const uint32_t shaderProgram, const std::string& name) -> int32_t;
 
 		std::map<std::string, int32_t> mUniformCache;
+		std::vector<std::string> mUniformBlocks;
 		std::map<ShaderType, std::string> mShaderFiles;
 		uint32_t mShaderProgram{0};
+		bool mInstanced{false};
 };
 }
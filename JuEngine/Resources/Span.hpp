@@ -0,0 +1,31 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include <cstddef>
+
+namespace JuEngine
+{
+// Non owning view of a contiguous range, only valid while the viewed container is not modified
+template <typename T>
+class Span
+{
+	public:
+		Span() = default;
+		Span(T* data, const std::size_t size) : mData(data), mSize(size) {}
+		template <typename TContainer> Span(TContainer& container) : mData(container.data()), mSize(container.size()) {}
+
+		inline auto begin() const -> T* { return mData; }
+		inline auto end() const -> T* { return mData + mSize; }
+		inline auto data() const -> T* { return mData; }
+		inline auto size() const -> std::size_t { return mSize; }
+		inline bool empty() const { return mSize == 0; }
+		inline auto operator [](const std::size_t index) const -> T& { return mData[index]; }
+
+	private:
+		T* mData{nullptr};
+		std::size_t mSize{0};
+};
+}
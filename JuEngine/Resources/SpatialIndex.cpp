@@ -0,0 +1,348 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "SpatialIndex.hpp"
+#include "MeshNode.hpp"
+#include "../Components/Light.hpp"
+#include "../Components/MeshRenderer.hpp"
+#include "../Components/Transform.hpp"
+#include "../Entity/Group.hpp"
+#include "../Entity/Pool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace JuEngine
+{
+// Attenuated light intensity (over 256 levels) below which the light is ignored
+static const float LightCutOff = 5.f / 256.f;
+
+SpatialIndex::SpatialIndex(Pool* pool)
+{
+	mPool = pool;
+	mGroupHandle = GroupHandle(pool, Matcher::Create(
+		{ ComponentTypeId::Get<Transform>() },
+		{ ComponentTypeId::Get<MeshRenderer>(), ComponentTypeId::Get<Light>() },
+		{}
+	));
+}
+
+// The group keeps alive while it's referenced, the pool could be already destroyed
+SpatialIndex::~SpatialIndex()
+{
+	Disconnect();
+}
+
+void SpatialIndex::Update()
+{
+	// The handlers of the group are removed when the groups of the pool are cleared
+	if(mGroup.get() != mGroupHandle.Get())
+	{
+		Resolve();
+	}
+
+	for(auto &object : mObjects)
+	{
+		auto transform = object.entity->Get<Transform>();
+		auto matrixVersion = transform->GetMatrixVersion();
+
+		if(! object.dirty && object.transform == transform && object.matrixVersion == matrixVersion)
+		{
+			continue;
+		}
+
+		object.transform = transform;
+		object.matrixVersion = matrixVersion;
+		object.dirty = false;
+		object.box = CalculateBox(object.entity, transform->GetMatrix());
+
+		if(object.box.IsEmpty())
+		{
+			if(object.proxy != BoundingVolumeHierarchy::NullNode)
+			{
+				mTree.Remove(object.proxy);
+				object.proxy = BoundingVolumeHierarchy::NullNode;
+			}
+		}
+		else if(object.proxy == BoundingVolumeHierarchy::NullNode)
+		{
+			object.proxy = mTree.Insert(object.box, object.entity->GetIndex());
+		}
+		else
+		{
+			mTree.Move(object.proxy, object.box);
+		}
+	}
+}
+
+// The bounds of an entity are calculated again in the next update (a changed mesh or light range)
+void SpatialIndex::Invalidate(const EntityPtr& entity)
+{
+	auto object = FindObject(entity);
+
+	if(object != nullptr)
+	{
+		object->dirty = true;
+	}
+}
+
+auto SpatialIndex::GetPool() const -> Pool*
+{
+	return mPool;
+}
+
+auto SpatialIndex::Count() const -> unsigned int
+{
+	return mObjects.size();
+}
+
+void SpatialIndex::Query(const BoundingBox& box, std::vector<EntityPtr>& entities)
+{
+	mProxies.clear();
+	mTree.Query(box, mProxies);
+
+	for(const auto &proxy : mProxies)
+	{
+		auto &object = GetProxyObject(proxy);
+
+		if(object.box.Intersects(box))
+		{
+			entities.push_back(object.entity);
+		}
+	}
+}
+
+void SpatialIndex::Query(const BoundingSphere& sphere, std::vector<EntityPtr>& entities)
+{
+	mProxies.clear();
+	mTree.Query(sphere, mProxies);
+
+	for(const auto &proxy : mProxies)
+	{
+		auto &object = GetProxyObject(proxy);
+
+		if(sphere.Intersects(object.box))
+		{
+			entities.push_back(object.entity);
+		}
+	}
+}
+
+void SpatialIndex::Query(const Frustum& frustum, std::vector<EntityPtr>& entities)
+{
+	mProxies.clear();
+	mTree.Query(frustum, mProxies);
+
+	for(const auto &proxy : mProxies)
+	{
+		auto &object = GetProxyObject(proxy);
+
+		if(frustum.Intersects(object.box))
+		{
+			entities.push_back(object.entity);
+		}
+	}
+}
+
+// Nearest box hit by the ray, the distance is zero if the origin is inside the box
+auto SpatialIndex::Raycast(const vec3& origin, const vec3& direction, const float maxDistance, RaycastHit& hit) -> bool
+{
+	float length = std::sqrt(direction.x * direction.x + direction.y * direction.y + direction.z * direction.z);
+
+	if(length == 0.f)
+	{
+		return false;
+	}
+
+	vec3 normalizedDirection = direction * (1.f / length);
+	vec3 inverseDirection;
+	bool found = false;
+	float distance;
+
+	for(unsigned int axis = 0; axis < 3; ++axis)
+	{
+		inverseDirection[axis] = (normalizedDirection[axis] != 0.f ? 1.f / normalizedDirection[axis] : std::numeric_limits<float>::infinity());
+	}
+
+	mProxies.clear();
+	mTree.Raycast(origin, normalizedDirection, maxDistance, mProxies);
+
+	for(const auto &proxy : mProxies)
+	{
+		auto &object = GetProxyObject(proxy);
+
+		if(object.box.Intersects(origin, inverseDirection, maxDistance, distance) && (! found || distance < hit.distance))
+		{
+			hit.entity = object.entity;
+			hit.distance = distance;
+			hit.point = origin + normalizedDirection * distance;
+			found = true;
+		}
+	}
+
+	return found;
+}
+
+// World box of the mesh node of the entity merged with the range of its light
+auto SpatialIndex::CalculateBox(const EntityPtr& entity, const mat4& matrix) -> BoundingBox
+{
+	BoundingBox box;
+
+	if(entity->Has<MeshRenderer>())
+	{
+		auto meshNode = entity->Get<MeshRenderer>()->GetMeshNode();
+
+		if(meshNode != nullptr)
+		{
+			box = meshNode->GetBoundingBox().Transform(matrix);
+		}
+	}
+
+	if(entity->Has<Light>())
+	{
+		auto light = entity->Get<Light>();
+
+		if(light->GetType() != LightType::LIGHT_DIRECTIONAL)
+		{
+			// Distance where 1 / (1 + linear * d + quadratic * d^2) falls below the cut off
+			auto color = light->GetColor() * light->GetIntensity();
+			float brightness = std::max(color.x, std::max(color.y, color.z));
+			float linear = light->GetLinearAttenuation();
+			float quadratic = light->GetQuadraticAttenuation();
+			float c = 1.f - brightness / LightCutOff;
+			float range = -1.f;
+
+			if(quadratic > 0.f)
+			{
+				range = (-linear + std::sqrt(linear * linear - 4.f * quadratic * c)) / (2.f * quadratic);
+			}
+			else if(linear > 0.f)
+			{
+				range = -c / linear;
+			}
+
+			if(range >= 0.f)
+			{
+				vec3 position = vec3(matrix[3]);
+
+				box.Encapsulate(position - vec3(range));
+				box.Encapsulate(position + vec3(range));
+			}
+		}
+	}
+
+	return box;
+}
+
+void SpatialIndex::Resolve()
+{
+	Disconnect();
+
+	mTree.Clear();
+	mObjects.clear();
+	mObjectForEntity.clear();
+
+	mGroup = mPool->GetGroup(mGroupHandle.GetMatcher());
+
+	for(const auto &entity : mGroup->GetEntityList())
+	{
+		AddObject(entity);
+	}
+
+	mAddedHandle = mGroup->OnEntityAdded.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		AddObject(entity);
+	});
+
+	mRemovedHandle = mGroup->OnEntityRemoved.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		RemoveObject(entity);
+	});
+
+	// A replaced mesh renderer or light changes the bounds, a replaced transform is detected by the update
+	mUpdatedHandle = mGroup->OnEntityUpdated.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)
+	{
+		Invalidate(entity);
+	});
+}
+
+void SpatialIndex::Disconnect()
+{
+	if(mGroup == nullptr)
+	{
+		return;
+	}
+
+	mGroup->OnEntityAdded.Unsubscribe(mAddedHandle);
+	mGroup->OnEntityRemoved.Unsubscribe(mRemovedHandle);
+	mGroup->OnEntityUpdated.Unsubscribe(mUpdatedHandle);
+	mGroup = nullptr;
+}
+
+// The new objects are inserted in the tree by the next update
+void SpatialIndex::AddObject(const EntityPtr& entity)
+{
+	auto index = entity->GetIndex();
+
+	if(index >= mObjectForEntity.size())
+	{
+		mObjectForEntity.resize(index + 1, 0);
+	}
+
+	if(mObjectForEntity[index] != 0)
+	{
+		return;
+	}
+
+	mObjects.push_back({entity, nullptr, 0, true, BoundingVolumeHierarchy::NullNode, BoundingBox()});
+	mObjectForEntity[index] = mObjects.size();
+}
+
+void SpatialIndex::RemoveObject(const EntityPtr& entity)
+{
+	auto object = FindObject(entity);
+
+	if(object == nullptr)
+	{
+		return;
+	}
+
+	if(object->proxy != BoundingVolumeHierarchy::NullNode)
+	{
+		mTree.Remove(object->proxy);
+	}
+
+	unsigned int node = object - mObjects.data();
+	unsigned int last = mObjects.size() - 1;
+
+	if(node != last)
+	{
+		mObjects[node] = std::move(mObjects[last]);
+		mObjectForEntity[mObjects[node].entity->GetIndex()] = node + 1;
+	}
+
+	mObjects.pop_back();
+	mObjectForEntity[entity->GetIndex()] = 0;
+}
+
+auto SpatialIndex::FindObject(const EntityPtr& entity) -> Object*
+{
+	auto index = entity->GetIndex();
+
+	if(index >= mObjectForEntity.size() || mObjectForEntity[index] == 0)
+	{
+		return nullptr;
+	}
+
+	auto &object = mObjects[mObjectForEntity[index] - 1];
+
+	return (object.entity == entity ? &object : nullptr);
+}
+
+// The tree stores the entity index of every proxy
+auto SpatialIndex::GetProxyObject(const int proxy) -> Object&
+{
+	return mObjects[mObjectForEntity[mTree.GetUserData(proxy)] - 1];
+}
+}
@@ -0,0 +1,78 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "BoundingVolumeHierarchy.hpp"
+#include "INonCopyable.hpp"
+#include "../Entity/GroupHandle.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+class Transform;
+
+struct JUENGINEAPI RaycastHit
+{
+	EntityPtr entity;
+	float distance;
+	vec3 point;
+};
+
+// Keeps the world boxes of the entities of a pool with a transform and a mesh renderer or a light
+// in a bounding volume hierarchy. The entities join and leave with the events of their group and
+// only the transforms whose matrix version changed are moved, so static entities aren't refitted.
+// Point and spot lights use the sphere where their attenuation is noticeable, directional lights
+// and lights without attenuation don't have bounds and aren't indexed.
+class JUENGINEAPI SpatialIndex : public INonCopyable
+{
+	public:
+		SpatialIndex(Pool* pool);
+		~SpatialIndex();
+
+		void Update();
+		void Invalidate(const EntityPtr& entity);
+		auto GetPool() const -> Pool*;
+		auto Count() const -> unsigned int;
+
+		// The entities are appended to the list
+		void Query(const BoundingBox& box, std::vector<EntityPtr>& entities);
+		void Query(const BoundingSphere& sphere, std::vector<EntityPtr>& entities);
+		void Query(const Frustum& frustum, std::vector<EntityPtr>& entities);
+		auto Raycast(const vec3& origin, const vec3& direction, const float maxDistance, RaycastHit& hit) -> bool;
+
+		static auto CalculateBox(const EntityPtr& entity, const mat4& matrix) -> BoundingBox;
+
+	private:
+		struct Object
+		{
+			EntityPtr entity;
+			Transform* transform;
+			unsigned int matrixVersion;
+			bool dirty;
+			int proxy;
+			BoundingBox box;
+		};
+
+		void Resolve();
+		void Disconnect();
+		void AddObject(const EntityPtr& entity);
+		void RemoveObject(const EntityPtr& entity);
+		auto FindObject(const EntityPtr& entity) -> Object*;
+		auto GetProxyObject(const int proxy) -> Object&;
+
+		Pool* mPool{nullptr};
+		GroupHandle mGroupHandle;
+		std::shared_ptr<Group> mGroup;
+		DelegateHandle mAddedHandle{0};
+		DelegateHandle mRemovedHandle{0};
+		DelegateHandle mUpdatedHandle{0};
+		BoundingVolumeHierarchy mTree;
+		std::vector<Object> mObjects;
+		std::vector<int> mProxies;
+
+		// Object index + 1 of every entity index, zero if the entity is not in the index
+		std::vector<unsigned int> mObjectForEntity;
+};
+}
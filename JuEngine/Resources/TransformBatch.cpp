@@ -0,0 +1,284 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "TransformBatch.hpp"
+
+#ifdef JUENGINE_SIMD_SSE
+	#include <xmmintrin.h>
+#endif
+
+namespace JuEngine
+{
+// Rotation matrix of the quaternion (columns c0, c1, c2) like glm::mat3_cast
+struct RotationTerms
+{
+	float r00, r01, r02;
+	float r10, r11, r12;
+	float r20, r21, r22;
+};
+
+static inline auto CalculateRotationTerms(const float x, const float y, const float z, const float w) -> RotationTerms
+{
+	float x2 = x + x, y2 = y + y, z2 = z + z;
+	float xx = x * x2, yy = y * y2, zz = z * z2;
+	float xy = x * y2, xz = x * z2, yz = y * z2;
+	float wx = w * x2, wy = w * y2, wz = w * z2;
+
+	return {
+		1.f - (yy + zz), xy + wz, xz - wy,
+		xy - wz, 1.f - (xx + zz), yz + wx,
+		xz + wy, yz - wx, 1.f - (xx + yy)
+	};
+}
+
+// T * R * S
+static inline void ComposeMatrix(const float px, const float py, const float pz, const RotationTerms& r, const float sx, const float sy, const float sz, mat4& m)
+{
+	m[0][0] = r.r00 * sx; m[0][1] = r.r01 * sx; m[0][2] = r.r02 * sx; m[0][3] = 0.f;
+	m[1][0] = r.r10 * sy; m[1][1] = r.r11 * sy; m[1][2] = r.r12 * sy; m[1][3] = 0.f;
+	m[2][0] = r.r20 * sz; m[2][1] = r.r21 * sz; m[2][2] = r.r22 * sz; m[2][3] = 0.f;
+	m[3][0] = px; m[3][1] = py; m[3][2] = pz; m[3][3] = 1.f;
+}
+
+// S^-1 * R^T * T^-1
+static inline void ComposeInverseMatrix(const float px, const float py, const float pz, const RotationTerms& r, const float sx, const float sy, const float sz, mat4& m)
+{
+	float isx = 1.f / sx, isy = 1.f / sy, isz = 1.f / sz;
+
+	m[0][0] = r.r00 * isx; m[0][1] = r.r10 * isy; m[0][2] = r.r20 * isz; m[0][3] = 0.f;
+	m[1][0] = r.r01 * isx; m[1][1] = r.r11 * isy; m[1][2] = r.r21 * isz; m[1][3] = 0.f;
+	m[2][0] = r.r02 * isx; m[2][1] = r.r12 * isy; m[2][2] = r.r22 * isz; m[2][3] = 0.f;
+	m[3][0] = -(r.r00 * px + r.r01 * py + r.r02 * pz) * isx;
+	m[3][1] = -(r.r10 * px + r.r11 * py + r.r12 * pz) * isy;
+	m[3][2] = -(r.r20 * px + r.r21 * py + r.r22 * pz) * isz;
+	m[3][3] = 1.f;
+}
+
+#ifdef JUENGINE_SIMD_SSE
+struct RotationTerms4
+{
+	__m128 r00, r01, r02;
+	__m128 r10, r11, r12;
+	__m128 r20, r21, r22;
+};
+
+static inline auto CalculateRotationTerms4(const __m128 x, const __m128 y, const __m128 z, const __m128 w) -> RotationTerms4
+{
+	const __m128 one = _mm_set1_ps(1.f);
+	__m128 x2 = _mm_add_ps(x, x), y2 = _mm_add_ps(y, y), z2 = _mm_add_ps(z, z);
+	__m128 xx = _mm_mul_ps(x, x2), yy = _mm_mul_ps(y, y2), zz = _mm_mul_ps(z, z2);
+	__m128 xy = _mm_mul_ps(x, y2), xz = _mm_mul_ps(x, z2), yz = _mm_mul_ps(y, z2);
+	__m128 wx = _mm_mul_ps(w, x2), wy = _mm_mul_ps(w, y2), wz = _mm_mul_ps(w, z2);
+
+	return {
+		_mm_sub_ps(one, _mm_add_ps(yy, zz)), _mm_add_ps(xy, wz), _mm_sub_ps(xz, wy),
+		_mm_sub_ps(xy, wz), _mm_sub_ps(one, _mm_add_ps(xx, zz)), _mm_add_ps(yz, wx),
+		_mm_add_ps(xz, wy), _mm_sub_ps(yz, wx), _mm_sub_ps(one, _mm_add_ps(xx, yy))
+	};
+}
+
+// Writes the same column of four consecutive matrices, one lane each
+static inline void StoreColumn4(__m128 x, __m128 y, __m128 z, __m128 w, mat4* matrices, const unsigned int column)
+{
+	_MM_TRANSPOSE4_PS(x, y, z, w);
+
+	_mm_storeu_ps(&matrices[0][column][0], x);
+	_mm_storeu_ps(&matrices[1][column][0], y);
+	_mm_storeu_ps(&matrices[2][column][0], z);
+	_mm_storeu_ps(&matrices[3][column][0], w);
+}
+
+static inline auto Cross4(const __m128 a, const __m128 b) -> __m128
+{
+	__m128 aYZX = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 aZXY = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+	__m128 bYZX = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+	__m128 bZXY = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+
+	return _mm_sub_ps(_mm_mul_ps(aYZX, bZXY), _mm_mul_ps(aZXY, bYZX));
+}
+#endif
+
+void TransformBatch::Clear()
+{
+	mPositionX.clear();
+	mPositionY.clear();
+	mPositionZ.clear();
+	mOrientationX.clear();
+	mOrientationY.clear();
+	mOrientationZ.clear();
+	mOrientationW.clear();
+	mScaleX.clear();
+	mScaleY.clear();
+	mScaleZ.clear();
+}
+
+void TransformBatch::Reserve(const unsigned int count)
+{
+	mPositionX.reserve(count);
+	mPositionY.reserve(count);
+	mPositionZ.reserve(count);
+	mOrientationX.reserve(count);
+	mOrientationY.reserve(count);
+	mOrientationZ.reserve(count);
+	mOrientationW.reserve(count);
+	mScaleX.reserve(count);
+	mScaleY.reserve(count);
+	mScaleZ.reserve(count);
+}
+
+void TransformBatch::Add(const vec3& position, const quat& orientation, const vec3& scale)
+{
+	mPositionX.push_back(position.x);
+	mPositionY.push_back(position.y);
+	mPositionZ.push_back(position.z);
+	mOrientationX.push_back(orientation.x);
+	mOrientationY.push_back(orientation.y);
+	mOrientationZ.push_back(orientation.z);
+	mOrientationW.push_back(orientation.w);
+	mScaleX.push_back(scale.x);
+	mScaleY.push_back(scale.y);
+	mScaleZ.push_back(scale.z);
+}
+
+auto TransformBatch::Count() const -> unsigned int
+{
+	return mPositionX.size();
+}
+
+void TransformBatch::CalculateMatrices(mat4* matrices) const
+{
+	unsigned int i = 0;
+	unsigned int count = Count();
+
+#ifdef JUENGINE_SIMD_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+
+	for(; i + 4 <= count; i += 4)
+	{
+		auto r = CalculateRotationTerms4(_mm_loadu_ps(&mOrientationX[i]), _mm_loadu_ps(&mOrientationY[i]), _mm_loadu_ps(&mOrientationZ[i]), _mm_loadu_ps(&mOrientationW[i]));
+		__m128 sx = _mm_loadu_ps(&mScaleX[i]);
+		__m128 sy = _mm_loadu_ps(&mScaleY[i]);
+		__m128 sz = _mm_loadu_ps(&mScaleZ[i]);
+
+		StoreColumn4(_mm_mul_ps(r.r00, sx), _mm_mul_ps(r.r01, sx), _mm_mul_ps(r.r02, sx), zero, &matrices[i], 0);
+		StoreColumn4(_mm_mul_ps(r.r10, sy), _mm_mul_ps(r.r11, sy), _mm_mul_ps(r.r12, sy), zero, &matrices[i], 1);
+		StoreColumn4(_mm_mul_ps(r.r20, sz), _mm_mul_ps(r.r21, sz), _mm_mul_ps(r.r22, sz), zero, &matrices[i], 2);
+		StoreColumn4(_mm_loadu_ps(&mPositionX[i]), _mm_loadu_ps(&mPositionY[i]), _mm_loadu_ps(&mPositionZ[i]), one, &matrices[i], 3);
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		auto r = CalculateRotationTerms(mOrientationX[i], mOrientationY[i], mOrientationZ[i], mOrientationW[i]);
+		ComposeMatrix(mPositionX[i], mPositionY[i], mPositionZ[i], r, mScaleX[i], mScaleY[i], mScaleZ[i], matrices[i]);
+	}
+}
+
+void TransformBatch::CalculateInverseMatrices(mat4* matrices) const
+{
+	unsigned int i = 0;
+	unsigned int count = Count();
+
+#ifdef JUENGINE_SIMD_SSE
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.f);
+
+	for(; i + 4 <= count; i += 4)
+	{
+		auto r = CalculateRotationTerms4(_mm_loadu_ps(&mOrientationX[i]), _mm_loadu_ps(&mOrientationY[i]), _mm_loadu_ps(&mOrientationZ[i]), _mm_loadu_ps(&mOrientationW[i]));
+		__m128 isx = _mm_div_ps(one, _mm_loadu_ps(&mScaleX[i]));
+		__m128 isy = _mm_div_ps(one, _mm_loadu_ps(&mScaleY[i]));
+		__m128 isz = _mm_div_ps(one, _mm_loadu_ps(&mScaleZ[i]));
+		__m128 px = _mm_loadu_ps(&mPositionX[i]);
+		__m128 py = _mm_loadu_ps(&mPositionY[i]);
+		__m128 pz = _mm_loadu_ps(&mPositionZ[i]);
+
+		__m128 tx = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r.r00, px), _mm_mul_ps(r.r01, py)), _mm_mul_ps(r.r02, pz));
+		__m128 ty = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r.r10, px), _mm_mul_ps(r.r11, py)), _mm_mul_ps(r.r12, pz));
+		__m128 tz = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r.r20, px), _mm_mul_ps(r.r21, py)), _mm_mul_ps(r.r22, pz));
+
+		StoreColumn4(_mm_mul_ps(r.r00, isx), _mm_mul_ps(r.r10, isy), _mm_mul_ps(r.r20, isz), zero, &matrices[i], 0);
+		StoreColumn4(_mm_mul_ps(r.r01, isx), _mm_mul_ps(r.r11, isy), _mm_mul_ps(r.r21, isz), zero, &matrices[i], 1);
+		StoreColumn4(_mm_mul_ps(r.r02, isx), _mm_mul_ps(r.r12, isy), _mm_mul_ps(r.r22, isz), zero, &matrices[i], 2);
+		StoreColumn4(_mm_sub_ps(zero, _mm_mul_ps(tx, isx)), _mm_sub_ps(zero, _mm_mul_ps(ty, isy)), _mm_sub_ps(zero, _mm_mul_ps(tz, isz)), one, &matrices[i], 3);
+	}
+#endif
+
+	for(; i < count; ++i)
+	{
+		auto r = CalculateRotationTerms(mOrientationX[i], mOrientationY[i], mOrientationZ[i], mOrientationW[i]);
+		ComposeInverseMatrix(mPositionX[i], mPositionY[i], mPositionZ[i], r, mScaleX[i], mScaleY[i], mScaleZ[i], matrices[i]);
+	}
+}
+
+auto TransformBatch::CalculateMatrix(const vec3& position, const quat& orientation, const vec3& scale) -> mat4
+{
+	mat4 matrix;
+	ComposeMatrix(position.x, position.y, position.z, CalculateRotationTerms(orientation.x, orientation.y, orientation.z, orientation.w), scale.x, scale.y, scale.z, matrix);
+
+	return matrix;
+}
+
+auto TransformBatch::CalculateInverseMatrix(const vec3& position, const quat& orientation, const vec3& scale) -> mat4
+{
+	mat4 matrix;
+	ComposeInverseMatrix(position.x, position.y, position.z, CalculateRotationTerms(orientation.x, orientation.y, orientation.z, orientation.w), scale.x, scale.y, scale.z, matrix);
+
+	return matrix;
+}
+
+// transpose(inverse(mat3(m))) of affine matrices, the columns are the cross products of the
+// other two columns divided by the determinant
+void TransformBatch::CalculateNormalMatrices(const mat4* matrices, mat3* normalMatrices, const unsigned int count)
+{
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		const mat4 &m = matrices[i];
+		mat3 &n = normalMatrices[i];
+
+#ifdef JUENGINE_SIMD_SSE
+		__m128 a0 = _mm_loadu_ps(&m[0][0]);
+		__m128 a1 = _mm_loadu_ps(&m[1][0]);
+		__m128 a2 = _mm_loadu_ps(&m[2][0]);
+
+		__m128 c0 = Cross4(a1, a2);
+		__m128 c1 = Cross4(a2, a0);
+		__m128 c2 = Cross4(a0, a1);
+
+		// The w lanes of the cross products are zero, so the horizontal sum is the determinant
+		__m128 det = _mm_mul_ps(a0, c0);
+		det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(2, 3, 0, 1)));
+		det = _mm_add_ps(det, _mm_shuffle_ps(det, det, _MM_SHUFFLE(1, 0, 3, 2)));
+		__m128 inverseDet = _mm_div_ps(_mm_set1_ps(1.f), det);
+
+		float column[4];
+
+		// mat3 columns are 3 floats wide, the 4th lane of a store is overwritten by the next column
+		_mm_storeu_ps(&n[0][0], _mm_mul_ps(c0, inverseDet));
+		_mm_storeu_ps(&n[1][0], _mm_mul_ps(c1, inverseDet));
+		_mm_storeu_ps(column, _mm_mul_ps(c2, inverseDet));
+		n[2][0] = column[0];
+		n[2][1] = column[1];
+		n[2][2] = column[2];
+#else
+		float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1];
+		float c01 = m[1][2] * m[2][0] - m[1][0] * m[2][2];
+		float c02 = m[1][0] * m[2][1] - m[1][1] * m[2][0];
+		float inverseDet = 1.f / (m[0][0] * c00 + m[0][1] * c01 + m[0][2] * c02);
+
+		n[0][0] = c00 * inverseDet;
+		n[0][1] = c01 * inverseDet;
+		n[0][2] = c02 * inverseDet;
+		n[1][0] = (m[2][1] * m[0][2] - m[2][2] * m[0][1]) * inverseDet;
+		n[1][1] = (m[2][2] * m[0][0] - m[2][0] * m[0][2]) * inverseDet;
+		n[1][2] = (m[2][0] * m[0][1] - m[2][1] * m[0][0]) * inverseDet;
+		n[2][0] = (m[0][1] * m[1][2] - m[0][2] * m[1][1]) * inverseDet;
+		n[2][1] = (m[0][2] * m[1][0] - m[0][0] * m[1][2]) * inverseDet;
+		n[2][2] = (m[0][0] * m[1][1] - m[0][1] * m[1][0]) * inverseDet;
+#endif
+	}
+}
+}
@@ -0,0 +1,46 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../DllExport.hpp"
+#include "Math.hpp"
+#include <vector>
+
+#if ! defined(JUENGINE_NO_SIMD) && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+	#define JUENGINE_SIMD_SSE
+#endif
+
+namespace JuEngine
+{
+// Position, rotation and scale of many transforms stored per component (SoA), so the matrices
+// are composed four at a time with SSE. The remaining transforms use the scalar version.
+class JUENGINEAPI TransformBatch
+{
+	public:
+		void Clear();
+		void Reserve(const unsigned int count);
+		void Add(const vec3& position, const quat& orientation, const vec3& scale);
+		auto Count() const -> unsigned int;
+
+		void CalculateMatrices(mat4* matrices) const;
+		void CalculateInverseMatrices(mat4* matrices) const;
+
+		static auto CalculateMatrix(const vec3& position, const quat& orientation, const vec3& scale) -> mat4;
+		static auto CalculateInverseMatrix(const vec3& position, const quat& orientation, const vec3& scale) -> mat4;
+		static void CalculateNormalMatrices(const mat4* matrices, mat3* normalMatrices, const unsigned int count);
+
+	private:
+		std::vector<float> mPositionX;
+		std::vector<float> mPositionY;
+		std::vector<float> mPositionZ;
+		std::vector<float> mOrientationX;
+		std::vector<float> mOrientationY;
+		std::vector<float> mOrientationZ;
+		std::vector<float> mOrientationW;
+		std::vector<float> mScaleX;
+		std::vector<float> mScaleY;
+		std::vector<float> mScaleZ;
+};
+}
@@ -0,0 +1,421 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "TransformHierarchy.hpp"
+#include "../Components/Transform.hpp"
+#include "../Entity/Group.hpp"
+#include "../Entity/Pool.hpp"
+#include "../App.hpp"
+#include <algorithm>
+#include <unordered_map>
+
+namespace JuEngine
+{
+const int TransformHierarchy::NoParent;
+const int TransformHierarchy::ExternalParent;
+
+TransformHierarchy::TransformHierarchy(Pool* pool)
+{
+	if(pool->GetStorageMode() != PoolStorageMode::Pointer)
+	{
+		ThrowRuntimeError("Error, transform hierarchy needs a pool with the Pointer storage mode");
+	}
+
+	mPool = pool;
+	mGroupHandle = GroupHandle(pool, Matcher_AllOf(Transform));
+}
+
+// The group keeps alive while it's referenced, the pool could be already destroyed
+TransformHierarchy::~TransformHierarchy()
+{
+	Disconnect();
+}
+
+void TransformHierarchy::Update()
+{
+	// The handlers of the group are removed when the groups of the pool are cleared
+	if(mGroup.get() != mGroupHandle.Get())
+	{
+		Resolve();
+	}
+
+	for(unsigned int i = 0, count = mTransforms.size(); ! mSortNeeded && i < count; ++i)
+	{
+		mSortNeeded = (mTransforms[i]->mParent != mParentTransforms[i]);
+	}
+
+	bool updateAll = mSortNeeded;
+
+	if(mSortNeeded)
+	{
+		SortNodes();
+	}
+
+	UpdateLocalMatrices();
+
+	// Parents are always before their children, so a dirty parent is already calculated
+	for(unsigned int i = 0, count = mTransforms.size(); i < count; ++i)
+	{
+		auto transform = mTransforms[i];
+		auto parent = mParents[i];
+		auto &localMatrix = transform->GetLocalMatrix();
+
+		bool dirty = updateAll || mLocalVersions[i] != transform->mLocalMatrixVersion || parent == ExternalParent || (parent >= 0 && mDirty[parent]);
+
+		mDirty[i] = dirty;
+
+		if(! dirty)
+		{
+			continue;
+		}
+
+		mLocalVersions[i] = transform->mLocalMatrixVersion;
+
+		if(parent >= 0)
+		{
+			mWorldMatrices[i] = mWorldMatrices[parent] * localMatrix;
+		}
+		else if(parent == ExternalParent)
+		{
+			mWorldMatrices[i] = transform->mParent->GetMatrix() * localMatrix;
+		}
+		else
+		{
+			mWorldMatrices[i] = localMatrix;
+		}
+	}
+
+	UpdateNormalMatrices();
+}
+
+auto TransformHierarchy::GetWorldMatrices() const -> const std::vector<mat4>&
+{
+	return mWorldMatrices;
+}
+
+auto TransformHierarchy::GetWorldMatrix(const EntityPtr& entity) const -> const mat4&
+{
+	auto node = GetNodeIndex(entity);
+
+	if(node < 0)
+	{
+		ThrowRuntimeError("Error, entity (%u) is not in the transform hierarchy", entity->GetUuid());
+	}
+
+	return mWorldMatrices[node];
+}
+
+auto TransformHierarchy::GetNormalMatrices() const -> const std::vector<mat3>&
+{
+	return mNormalMatrices;
+}
+
+auto TransformHierarchy::GetNormalMatrix(const EntityPtr& entity) const -> const mat3&
+{
+	auto node = GetNodeIndex(entity);
+
+	if(node < 0)
+	{
+		ThrowRuntimeError("Error, entity (%u) is not in the transform hierarchy", entity->GetUuid());
+	}
+
+	return mNormalMatrices[node];
+}
+
+auto TransformHierarchy::GetNodeIndex(const EntityPtr& entity) const -> int
+{
+	auto index = entity->GetIndex();
+
+	if(index >= mNodeForEntity.size())
+	{
+		return -1;
+	}
+
+	return (int)mNodeForEntity[index] - 1;
+}
+
+auto TransformHierarchy::Count() const -> unsigned int
+{
+	return mTransforms.size();
+}
+
+void TransformHierarchy::Resolve()
+{
+	Disconnect();
+
+	mEntities.clear();
+	mTransforms.clear();
+	mParentTransforms.clear();
+	mParents.clear();
+	mLocalVersions.clear();
+	mDirty.clear();
+	mWorldMatrices.clear();
+	mNormalMatrices.clear();
+	mNodeForEntity.clear();
+
+	mGroup = mPool->GetGroup(mGroupHandle.GetMatcher());
+
+	for(const auto &entity : mGroup->GetEntityList())
+	{
+		AddNode(entity);
+	}
+
+	mAddedHandle = mGroup->OnEntityAdded.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		AddNode(entity);
+	});
+
+	mRemovedHandle = mGroup->OnEntityRemoved.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* component)
+	{
+		RemoveNode(entity);
+	});
+
+	mUpdatedHandle = mGroup->OnEntityUpdated.Subscribe([this](std::shared_ptr<Group> group, EntityPtr entity, ComponentId index, IComponent* previousComponent, IComponent* newComponent)
+	{
+		if(previousComponent != newComponent && index == ComponentTypeId::Get<Transform>())
+		{
+			ReplaceNode(entity);
+		}
+	});
+}
+
+void TransformHierarchy::Disconnect()
+{
+	if(mGroup == nullptr)
+	{
+		return;
+	}
+
+	mGroup->OnEntityAdded.Unsubscribe(mAddedHandle);
+	mGroup->OnEntityRemoved.Unsubscribe(mRemovedHandle);
+	mGroup->OnEntityUpdated.Unsubscribe(mUpdatedHandle);
+	mGroup = nullptr;
+}
+
+void TransformHierarchy::AddNode(const EntityPtr& entity)
+{
+	auto index = entity->GetIndex();
+
+	if(index >= mNodeForEntity.size())
+	{
+		mNodeForEntity.resize(index + 1, 0);
+	}
+
+	if(mNodeForEntity[index] != 0)
+	{
+		return;
+	}
+
+	mEntities.push_back(entity.get());
+	mTransforms.push_back(entity->Get<Transform>());
+	mParentTransforms.push_back(nullptr);
+	mParents.push_back(NoParent);
+	mLocalVersions.push_back(0);
+	mDirty.push_back(1);
+	mWorldMatrices.push_back(mat4(1.f));
+	mNormalMatrices.push_back(mat3(1.f));
+
+	mNodeForEntity[index] = mTransforms.size();
+	mSortNeeded = true;
+}
+
+void TransformHierarchy::RemoveNode(const EntityPtr& entity)
+{
+	auto node = GetNodeIndex(entity);
+
+	if(node < 0)
+	{
+		return;
+	}
+
+	unsigned int last = mTransforms.size() - 1;
+
+	if((unsigned int)node != last)
+	{
+		mEntities[node] = mEntities[last];
+		mTransforms[node] = mTransforms[last];
+		mParentTransforms[node] = mParentTransforms[last];
+		mParents[node] = mParents[last];
+		mLocalVersions[node] = mLocalVersions[last];
+		mDirty[node] = mDirty[last];
+		mWorldMatrices[node] = mWorldMatrices[last];
+		mNormalMatrices[node] = mNormalMatrices[last];
+
+		mNodeForEntity[mEntities[node]->GetIndex()] = node + 1;
+	}
+
+	mEntities.pop_back();
+	mTransforms.pop_back();
+	mParentTransforms.pop_back();
+	mParents.pop_back();
+	mLocalVersions.pop_back();
+	mDirty.pop_back();
+	mWorldMatrices.pop_back();
+	mNormalMatrices.pop_back();
+
+	mNodeForEntity[entity->GetIndex()] = 0;
+	mSortNeeded = true;
+}
+
+void TransformHierarchy::ReplaceNode(const EntityPtr& entity)
+{
+	auto node = GetNodeIndex(entity);
+
+	if(node < 0)
+	{
+		return;
+	}
+
+	mTransforms[node] = entity->Get<Transform>();
+	mSortNeeded = true;
+}
+
+// Counting sort by depth, the depth of every node is calculated once walking up to a known node
+void TransformHierarchy::SortNodes()
+{
+	unsigned int count = mTransforms.size();
+	std::unordered_map<Transform*, int> nodeForTransform;
+	std::vector<int> depths(count, -1);
+	std::vector<int> path;
+	int maxDepth = 0;
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		nodeForTransform[mTransforms[i]] = i;
+	}
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		int current = i;
+		path.clear();
+
+		while(current >= 0 && depths[current] < 0)
+		{
+			path.push_back(current);
+
+			if(path.size() > count)
+			{
+				ThrowRuntimeError("Error, transform hierarchy has a cycle in the parent of entity (%u)", mEntities[i]->GetUuid());
+			}
+
+			auto it = nodeForTransform.find(mTransforms[current]->mParent);
+			current = (it != nodeForTransform.end() ? it->second : -1);
+		}
+
+		int depth = (current >= 0 ? depths[current] + 1 : 0);
+
+		for(auto it = path.rbegin(); it != path.rend(); ++it)
+		{
+			depths[*it] = depth++;
+		}
+
+		maxDepth = std::max(maxDepth, depth);
+	}
+
+	std::vector<unsigned int> offsets(maxDepth + 1, 0);
+	std::vector<unsigned int> order(count);
+	std::vector<int> newNodes(count);
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		++offsets[depths[i] + 1];
+	}
+
+	for(int depth = 1; depth <= maxDepth; ++depth)
+	{
+		offsets[depth] += offsets[depth - 1];
+	}
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		auto newNode = offsets[depths[i]]++;
+		order[newNode] = i;
+		newNodes[i] = newNode;
+	}
+
+	std::vector<Entity*> entities(count);
+	std::vector<Transform*> transforms(count);
+	std::vector<mat4> worldMatrices(count);
+	std::vector<mat3> normalMatrices(count);
+
+	for(unsigned int i = 0; i < count; ++i)
+	{
+		auto previousNode = order[i];
+		auto parentTransform = mTransforms[previousNode]->mParent;
+
+		entities[i] = mEntities[previousNode];
+		transforms[i] = mTransforms[previousNode];
+		worldMatrices[i] = mWorldMatrices[previousNode];
+		normalMatrices[i] = mNormalMatrices[previousNode];
+		mParentTransforms[i] = parentTransform;
+
+		if(parentTransform == nullptr)
+		{
+			mParents[i] = NoParent;
+		}
+		else if(nodeForTransform.count(parentTransform) > 0)
+		{
+			mParents[i] = newNodes[nodeForTransform[parentTransform]];
+		}
+		else
+		{
+			mParents[i] = ExternalParent;
+		}
+
+		mNodeForEntity[entities[i]->GetIndex()] = i + 1;
+	}
+
+	mEntities.swap(entities);
+	mTransforms.swap(transforms);
+	mWorldMatrices.swap(worldMatrices);
+	mNormalMatrices.swap(normalMatrices);
+
+	mSortNeeded = false;
+}
+
+void TransformHierarchy::UpdateLocalMatrices()
+{
+	mBatch.Clear();
+	mBatchTransforms.clear();
+
+	for(const auto &transform : mTransforms)
+	{
+		if(transform->mMatrixRefreshNeeded)
+		{
+			mBatch.Add(transform->mPosition, transform->mOrientation, transform->mScale);
+			mBatchTransforms.push_back(transform);
+		}
+	}
+
+	mBatchMatrices.resize(mBatchTransforms.size());
+	mBatch.CalculateMatrices(mBatchMatrices.data());
+
+	for(unsigned int i = 0, count = mBatchTransforms.size(); i < count; ++i)
+	{
+		mBatchTransforms[i]->SetLocalMatrix(mBatchMatrices[i]);
+	}
+}
+
+// The changed nodes are usually grouped (whole branches), so they are calculated in runs
+void TransformHierarchy::UpdateNormalMatrices()
+{
+	for(unsigned int i = 0, count = mTransforms.size(); i < count;)
+	{
+		if(! mDirty[i])
+		{
+			++i;
+			continue;
+		}
+
+		unsigned int first = i;
+
+		while(i < count && mDirty[i])
+		{
+			++i;
+		}
+
+		TransformBatch::CalculateNormalMatrices(&mWorldMatrices[first], &mNormalMatrices[first], i - first);
+	}
+}
+}
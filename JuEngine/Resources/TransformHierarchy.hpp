@@ -0,0 +1,73 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "INonCopyable.hpp"
+#include "Math.hpp"
+#include "TransformBatch.hpp"
+#include "../Entity/GroupHandle.hpp"
+#include <vector>
+
+namespace JuEngine
+{
+class Transform;
+
+// Keeps the transforms of a pool sorted by depth (parents before children) in flat arrays and
+// calculates every world matrix in a single pass, only the changed branches are recalculated.
+// It requires the Pointer storage mode of the pool because it keeps pointers to the transforms.
+class JUENGINEAPI TransformHierarchy : public INonCopyable
+{
+	public:
+		TransformHierarchy(Pool* pool);
+		~TransformHierarchy();
+
+		void Update();
+		auto GetWorldMatrices() const -> const std::vector<mat4>&;
+		auto GetWorldMatrix(const EntityPtr& entity) const -> const mat4&;
+		auto GetNormalMatrices() const -> const std::vector<mat3>&;
+		auto GetNormalMatrix(const EntityPtr& entity) const -> const mat3&;
+		auto GetNodeIndex(const EntityPtr& entity) const -> int;
+		auto Count() const -> unsigned int;
+
+	private:
+		void Resolve();
+		void Disconnect();
+		void AddNode(const EntityPtr& entity);
+		void RemoveNode(const EntityPtr& entity);
+		void ReplaceNode(const EntityPtr& entity);
+		void SortNodes();
+		void UpdateLocalMatrices();
+		void UpdateNormalMatrices();
+
+		static const int NoParent = -1;
+		static const int ExternalParent = -2;
+
+		Pool* mPool{nullptr};
+		GroupHandle mGroupHandle;
+		std::shared_ptr<Group> mGroup;
+		DelegateHandle mAddedHandle{0};
+		DelegateHandle mRemovedHandle{0};
+		DelegateHandle mUpdatedHandle{0};
+		bool mSortNeeded{false};
+
+		// One element per node, sorted by depth after SortNodes
+		std::vector<Entity*> mEntities;
+		std::vector<Transform*> mTransforms;
+		std::vector<Transform*> mParentTransforms;
+		std::vector<int> mParents;
+		std::vector<unsigned int> mLocalVersions;
+		std::vector<char> mDirty;
+		std::vector<mat4> mWorldMatrices;
+		std::vector<mat3> mNormalMatrices;
+
+		// The changed local matrices are calculated together every update
+		TransformBatch mBatch;
+		std::vector<Transform*> mBatchTransforms;
+		std::vector<mat4> mBatchMatrices;
+
+		// Node index + 1 of every entity index, zero if the entity is not in the hierarchy
+		std::vector<unsigned int> mNodeForEntity;
+};
+}
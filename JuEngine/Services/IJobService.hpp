@@ -0,0 +1,91 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../Resources/IObject.hpp"
+#include "../Resources/INonCopyable.hpp"
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace JuEngine
+{
+typedef std::function<void()> Job;
+
+// Counts the unfinished jobs that signal it, other jobs can wait for it or depend on it
+class JUENGINEAPI JobCounter : public INonCopyable
+{
+	friend class JobManager;
+
+	public:
+		JobCounter() = default;
+
+		inline bool IsDone() const { return mCount.load() == 0; }
+
+	private:
+		std::atomic<unsigned int> mCount{0};
+		std::mutex mMutex;
+		std::vector<std::pair<Job, JobCounter*>> mContinuations;
+};
+
+// Jobs must not throw. A thread waiting for a counter executes other jobs in the meantime, so
+// jobs can wait for other jobs (like a parallel for inside a job) without blocking a worker.
+class JUENGINEAPI IJobService : public IObject
+{
+	public:
+		// The job signals the counter when it ends and doesn't start until the dependency is done
+		virtual void Run(Job job, JobCounter* counter = nullptr, JobCounter* dependency = nullptr) = 0;
+		virtual void Wait(JobCounter& counter) = 0;
+		virtual auto GetWorkerCount() const -> unsigned int = 0;
+
+		// The function receives ranges [begin, end) of at most grainSize elements
+		template <typename TFunction> inline void ParallelFor(const unsigned int count, const unsigned int grainSize, TFunction function);
+		template <typename TFunction> inline void ParallelFor(const unsigned int count, TFunction function);
+};
+
+template <typename TFunction>
+void IJobService::ParallelFor(const unsigned int count, const unsigned int grainSize, TFunction function)
+{
+	const unsigned int grain = std::max(grainSize, 1u);
+
+	if(count <= grain || GetWorkerCount() == 0)
+	{
+		if(count > 0)
+		{
+			function(0u, count);
+		}
+
+		return;
+	}
+
+	JobCounter counter;
+
+	// The first range runs in this thread
+	for(unsigned int begin = grain; begin < count; begin += grain)
+	{
+		const unsigned int end = std::min(begin + grain, count);
+
+		Run([&function, begin, end]()
+		{
+			function(begin, end);
+		}, &counter);
+	}
+
+	function(0u, grain);
+	Wait(counter);
+}
+
+template <typename TFunction>
+void IJobService::ParallelFor(const unsigned int count, TFunction function)
+{
+	// Around four ranges per thread to balance the work
+	const unsigned int rangeCount = (GetWorkerCount() + 1) * 4;
+
+	ParallelFor(count, (count + rangeCount - 1) / rangeCount, std::move(function));
+}
+}
@@ -0,0 +1,29 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#pragma once
+
+#include "../Resources/IObject.hpp"
+#include "../Resources/SpatialIndex.hpp"
+
+namespace JuEngine
+{
+// Spatial queries over the entities of the registered pools (see SpatialIndex). The index is
+// updated by the app before the systems execute, the transforms changed later are seen in the
+// next update (or after calling Update).
+class JUENGINEAPI ISpatialService : public IObject
+{
+	public:
+		virtual void Register(Pool* pool) = 0;
+		virtual void Reset() = 0;
+		virtual void Update() = 0;
+		virtual void Invalidate(const EntityPtr& entity) = 0;
+
+		// The list is cleared before adding the entities found
+		virtual void Query(const BoundingBox& box, std::vector<EntityPtr>& entities) = 0;
+		virtual void Query(const BoundingSphere& sphere, std::vector<EntityPtr>& entities) = 0;
+		virtual void Query(const Frustum& frustum, std::vector<EntityPtr>& entities) = 0;
+		virtual auto Raycast(const vec3& origin, const vec3& direction, const float maxDistance, RaycastHit& hit) -> bool = 0;
+};
+}
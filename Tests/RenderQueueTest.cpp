@@ -0,0 +1,141 @@
+// Copyright (c) 2016 Juan Delgado (JuDelCo)
+// License: GPLv3 License
+// GPLv3 License web page: http://www.gnu.org/licenses/gpl.txt
+
+#include "JuEngine/Resources/RecordingRenderBackend.hpp"
+#include "JuEngine/Resources/RenderQueue.hpp"
+#include <cstdio>
+#include <vector>
+
+using namespace JuEngine;
+
+static unsigned int FailureCount = 0;
+
+#define CHECK_EQUAL(VALUE, EXPECTED) \
+	if((VALUE) != (EXPECTED)) \
+	{ \
+		printf("%s:%d: %s is %u, expected %u\n", __FILE__, __LINE__, #VALUE, (unsigned int)(VALUE), (unsigned int)(EXPECTED)); \
+		++FailureCount; \
+	}
+
+// The backend only records the pointers, so any distinct addresses work as resources
+static char Resources[8];
+static Shader* ShaderA = reinterpret_cast<Shader*>(&Resources[0]);
+static Shader* ShaderB = reinterpret_cast<Shader*>(&Resources[1]);
+static Material* MaterialA = reinterpret_cast<Material*>(&Resources[2]);
+static Material* MaterialB = reinterpret_cast<Material*>(&Resources[3]);
+static Material* MaterialC = reinterpret_cast<Material*>(&Resources[4]);
+static Mesh* MeshA = reinterpret_cast<Mesh*>(&Resources[5]);
+static Mesh* MeshB = reinterpret_cast<Mesh*>(&Resources[6]);
+
+static const mat4 ModelMatrix(1.f);
+static const mat3 NormalMatrix(1.f);
+
+// Ten draws of four different states, added interleaved
+static void FillScene(RenderQueue& queue)
+{
+	struct Draw
+	{
+		Shader* shader;
+		Material* material;
+		Mesh* mesh;
+	};
+
+	const Draw draws[] = {
+		{ShaderB, MaterialC, MeshB},
+		{ShaderA, MaterialA, MeshA},
+		{ShaderA, MaterialB, MeshA},
+		{ShaderA, MaterialA, MeshB},
+		{ShaderB, MaterialC, MeshB},
+		{ShaderA, MaterialA, MeshA},
+		{ShaderA, MaterialB, MeshA},
+		{ShaderB, MaterialC, MeshB},
+		{ShaderA, MaterialA, MeshA},
+		{ShaderB, MaterialC, MeshB}
+	};
+
+	queue.Clear();
+
+	for(unsigned int i = 0; i < 10; ++i)
+	{
+		queue.Add(0, draws[i].shader, draws[i].material, draws[i].mesh, &ModelMatrix, &NormalMatrix, 10.f - i);
+	}
+
+	queue.Sort();
+}
+
+static void TestSortedScene()
+{
+	RenderQueue queue;
+	RecordingRenderBackend backend;
+
+	FillScene(queue);
+	queue.Submit(&backend);
+
+	// 2 shaders + 2 meshes + 3 materials (the mesh is kept between the shaders)
+	CHECK_EQUAL(queue.Count(), 10);
+	CHECK_EQUAL(backend.GetStateChangeCount(), 7);
+	CHECK_EQUAL(backend.GetDrawCallCount(), 10);
+	CHECK_EQUAL(backend.GetInstanceCount(), 0);
+}
+
+static void TestInstancedScene()
+{
+	RenderQueue queue;
+	RecordingRenderBackend backend;
+
+	backend.SetInstancing(true);
+	FillScene(queue);
+	queue.Submit(&backend);
+
+	CHECK_EQUAL(backend.GetStateChangeCount(), 7);
+	CHECK_EQUAL(backend.GetDrawCallCount(), 4);
+	CHECK_EQUAL(backend.GetInstanceCount(), 10);
+}
+
+// A shader used every frame with a new shader each frame (more than the 4096 shader ids over all
+// the frames): the ids are given again after Clear, so the two shaders are never mixed by depth
+static void TestIdsPerFrame()
+{
+	const unsigned int frameCount = 4200;
+	std::vector<char> frameShaders(frameCount);
+	RenderQueue queue;
+	RecordingRenderBackend backend;
+
+	for(unsigned int frame = 0; frame < frameCount; ++frame)
+	{
+		auto frameShader = reinterpret_cast<Shader*>(&frameShaders[frame]);
+
+		queue.Clear();
+		queue.Add(0, ShaderA, MaterialA, MeshA, &ModelMatrix, &NormalMatrix, 1.f);
+		queue.Add(0, frameShader, MaterialA, MeshA, &ModelMatrix, &NormalMatrix, 2.f);
+		queue.Add(0, ShaderA, MaterialA, MeshA, &ModelMatrix, &NormalMatrix, 3.f);
+		queue.Add(0, frameShader, MaterialA, MeshA, &ModelMatrix, &NormalMatrix, 4.f);
+		queue.Sort();
+
+		backend.Reset();
+		queue.Submit(&backend);
+
+		if(backend.GetCallCount(RenderBackendCall::UseShader) != 2)
+		{
+			CHECK_EQUAL(backend.GetCallCount(RenderBackendCall::UseShader), 2);
+			break;
+		}
+	}
+}
+
+int main()
+{
+	TestSortedScene();
+	TestInstancedScene();
+	TestIdsPerFrame();
+
+	if(FailureCount > 0)
+	{
+		printf("%u checks failed\n", FailureCount);
+
+		return 1;
+	}
+
+	return 0;
+}